@@ -25,6 +25,30 @@ ASTNode::ASTNode(const Token &theToken) :
 {
 }
 
+//******************
+// ASTNode::~ASTNode
+//******************
+ASTNode::~ASTNode()
+{
+  std::vector<std::shared_ptr<ASTNode>> pending;
+  pending.swap(myChildren);
+  while (! pending.empty())
+  {
+    auto node = std::move(pending.back());
+    pending.pop_back();
+    // Only take over the children of nodes which are about to be deleted
+    // (copies of this node share children).
+    if (node.use_count() == 1)
+    {
+      for (auto &child : node->myChildren)
+      {
+        pending.push_back(std::move(child));
+      }
+      node->myChildren.clear();
+    }
+  }
+}
+
 //******************
 // ASTNode::addChild
 //******************
@@ -63,9 +63,10 @@ class ASTNode
   ASTNode(const Token &theToken);
 
   /**
-   * Destructor
+   * Destructor. Releases descendants iteratively, as the tree can be as deep
+   * as the program is long.
    */
-  ~ASTNode() = default;
+  ~ASTNode();
 
   /**
    * Copy assignment operator.
@@ -0,0 +1,63 @@
+/**
+ * @file AnalysisManager.cpp
+ * @brief Implementation of AnalysisManager class
+ *
+ * @author Michael Albers
+ */
+
+#include "AnalysisManager.h"
+#include "SSAForm.h"
+
+//**************************************************
+// AnalysisManager::AnalysisManager
+//**************************************************
+AnalysisManager::AnalysisManager() = default;
+
+//**************************************************
+// AnalysisManager::~AnalysisManager
+//**************************************************
+AnalysisManager::~AnalysisManager() = default;
+
+//**************************************************
+// AnalysisManager::getComputedCount
+//**************************************************
+uint64_t AnalysisManager::getComputedCount() const noexcept
+{
+  return myComputed;
+}
+
+//**************************************************
+// AnalysisManager::getReusedCount
+//**************************************************
+uint64_t AnalysisManager::getReusedCount() const noexcept
+{
+  return myReused;
+}
+
+//**************************************************
+// AnalysisManager::getSSAForm
+//**************************************************
+const SSAForm& AnalysisManager::getSSAForm(const Program &theProgram)
+{
+  if (mySSAForm)
+  {
+    ++myReused;
+  }
+  else
+  {
+    mySSAForm.reset(new SSAForm(theProgram));
+    ++myComputed;
+  }
+  return *mySSAForm;
+}
+
+//**************************************************
+// AnalysisManager::invalidate
+//**************************************************
+void AnalysisManager::invalidate(uint32_t thePreserved) noexcept
+{
+  if (0 == (thePreserved & SSA))
+  {
+    mySSAForm.reset();
+  }
+}
@@ -0,0 +1,120 @@
+#ifndef ANALYSISMANAGER_H
+#define ANALYSISMANAGER_H
+
+/**
+ * @file AnalysisManager.h
+ * @brief Defines the cache of analyses shared by optimization passes.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <memory>
+
+class Program;
+class SSAForm;
+
+/**
+ * Computes analyses of a program on demand and keeps them until a pass
+ * changes something they depend on. After each pass the pass manager
+ * invalidates every analysis the pass doesn't preserve (see
+ * Pass::getPreservedAnalyses); a pass which uses an analysis after changing
+ * the program itself must invalidate it first.
+ */
+class AnalysisManager
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** Analyses, as bit flags. */
+  enum Analysis : uint32_t
+  {
+    NONE = 0,
+    SSA = 1u << 0,
+    ALL = ~0u
+  };
+
+  /**
+   * Default constructor.
+   */
+  AnalysisManager();
+
+  /**
+   * Copy constructor
+   */
+  AnalysisManager(const AnalysisManager &) = delete;
+
+  /**
+   * Move constructor
+   */
+  AnalysisManager(AnalysisManager &&) = default;
+
+  /**
+   * Destructor
+   */
+  ~AnalysisManager();
+
+  /**
+   * Copy assignment operator
+   */
+  AnalysisManager& operator=(const AnalysisManager &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  AnalysisManager& operator=(AnalysisManager &&) = default;
+
+  /**
+   * Returns the number of analyses computed.
+   *
+   * @return number computed
+   */
+  uint64_t getComputedCount() const noexcept;
+
+  /**
+   * Returns the number of requests answered from the cache.
+   *
+   * @return number reused
+   */
+  uint64_t getReusedCount() const noexcept;
+
+  /**
+   * Returns the SSA form of the program, computing it if needed.
+   *
+   * @param theProgram
+   *          program
+   * @return SSA form
+   */
+  const SSAForm& getSSAForm(const Program &theProgram);
+
+  /**
+   * Discards every analysis not preserved.
+   *
+   * @param thePreserved
+   *          analyses still valid (Analysis flags)
+   */
+  void invalidate(uint32_t thePreserved) noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Number of analyses computed. */
+  uint64_t myComputed = 0;
+
+  /** Number of requests answered from the cache. */
+  uint64_t myReused = 0;
+
+  /** SSA form, null if not computed. */
+  std::unique_ptr<SSAForm> mySSAForm;
+};
+
+#endif
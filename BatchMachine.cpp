@@ -0,0 +1,425 @@
+/**
+ * @file BatchMachine.cpp
+ * @brief Implementation of BatchMachine class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "BatchMachine.h"
+#include "Bytecode.h"
+#include "Runtime.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define MICRO_AVX2 1
+#endif
+
+constexpr uint32_t BatchMachine::BLOCK_SIZE;
+
+//**************************************************
+// BatchMachine::BatchMachine
+//**************************************************
+BatchMachine::BatchMachine(bool theBinary) :
+  myAdd(addScalar),
+  myBinary(theBinary),
+  myBuffer(1 << 16),
+  mySubtract(subtractScalar),
+  myVectorWidth(1)
+{
+#ifdef MICRO_AVX2
+  if (__builtin_cpu_supports("avx2"))
+  {
+    myAdd = addAvx2;
+    mySubtract = subtractAvx2;
+    myVectorWidth = 4;
+  }
+#endif
+}
+
+#ifdef MICRO_AVX2
+//**************************************************
+// BatchMachine::addAvx2
+//**************************************************
+__attribute__((target("avx2")))
+void BatchMachine::addAvx2(const int64_t *theLeft, const int64_t *theRight,
+                           int64_t *theResult)
+{
+  for (uint32_t ii = 0; ii < BLOCK_SIZE; ii += 4)
+  {
+    auto left = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(theLeft + ii));
+    auto right = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(theRight + ii));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(theResult + ii),
+                        _mm256_add_epi64(left, right));
+  }
+}
+
+//**************************************************
+// BatchMachine::subtractAvx2
+//**************************************************
+__attribute__((target("avx2")))
+void BatchMachine::subtractAvx2(const int64_t *theLeft,
+                                const int64_t *theRight, int64_t *theResult)
+{
+  for (uint32_t ii = 0; ii < BLOCK_SIZE; ii += 4)
+  {
+    auto left = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(theLeft + ii));
+    auto right = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(theRight + ii));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(theResult + ii),
+                        _mm256_sub_epi64(left, right));
+  }
+}
+#endif
+
+//**************************************************
+// BatchMachine::addScalar
+//**************************************************
+void BatchMachine::addScalar(const int64_t *theLeft, const int64_t *theRight,
+                             int64_t *theResult)
+{
+  for (uint32_t ii = 0; ii < BLOCK_SIZE; ++ii)
+  {
+    theResult[ii] = static_cast<int64_t>(
+      static_cast<uint64_t>(theLeft[ii]) + static_cast<uint64_t>(theRight[ii]));
+  }
+}
+
+//**************************************************
+// BatchMachine::getRecordCount
+//**************************************************
+uint64_t BatchMachine::getRecordCount() const noexcept
+{
+  return myRecordCount;
+}
+
+//**************************************************
+// BatchMachine::getVectorWidth
+//**************************************************
+uint32_t BatchMachine::getVectorWidth() const noexcept
+{
+  return myVectorWidth;
+}
+
+//**************************************************
+// BatchMachine::next
+//**************************************************
+int BatchMachine::next()
+{
+  if (myBufferPosition == myBufferLength)
+  {
+    myBufferLength = std::fread(myBuffer.data(), 1, myBuffer.size(), myInput);
+    myBufferPosition = 0;
+    if (0 == myBufferLength)
+    {
+      return EOF;
+    }
+  }
+  return static_cast<unsigned char>(myBuffer[myBufferPosition++]);
+}
+
+//**************************************************
+// BatchMachine::readBlock
+//**************************************************
+uint32_t BatchMachine::readBlock(uint32_t theFieldCount)
+{
+  if (myBinary)
+  {
+    // Whole records are read, then transposed into the columns.
+    std::vector<int64_t> records(BLOCK_SIZE * theFieldCount);
+    auto recordSize = sizeof(int64_t) * theFieldCount;
+    auto bytes = std::fread(records.data(), 1, recordSize * BLOCK_SIZE,
+                            myInput);
+    uint32_t count = bytes / recordSize;
+    if (0 != bytes % recordSize)
+    {
+      throw std::runtime_error(
+        "Input record " + std::to_string(myRecordCount + count + 1) +
+        " is truncated.");
+    }
+    for (uint32_t record = 0; record < count; ++record)
+    {
+      for (uint32_t field = 0; field < theFieldCount; ++field)
+      {
+        myInputColumns[field * BLOCK_SIZE + record] =
+          records[record * theFieldCount + field];
+      }
+    }
+    return count;
+  }
+
+  uint32_t count = 0;
+  auto malformed = [&]()
+  {
+    return std::runtime_error(
+      "Input record " + std::to_string(myRecordCount + count + 1) +
+      " isn't " + std::to_string(theFieldCount) + " integers.");
+  };
+  int c = next();
+  while (count < BLOCK_SIZE && EOF != c)
+  {
+    // Fields are separated by blanks, a comma or both; there can't be an
+    // empty field, so a comma must have a field on each side.
+    uint32_t fields = 0;
+    bool comma = false;
+    bool separated = true;
+    while (EOF != c && '\n' != c)
+    {
+      if (' ' == c || '\t' == c || '\r' == c || ',' == c)
+      {
+        if (',' == c && (comma || 0 == fields))
+        {
+          throw malformed();
+        }
+        comma = comma || (',' == c);
+        separated = true;
+        c = next();
+        continue;
+      }
+
+      bool negative = ('-' == c);
+      if ('-' == c || '+' == c)
+      {
+        c = next();
+      }
+      if (c < '0' || c > '9' || ! separated || fields == theFieldCount)
+      {
+        throw malformed();
+      }
+      // The digits may run past the buffer.
+      uint64_t value = 0;
+      while (c >= '0' && c <= '9')
+      {
+        value = value * 10 + (c - '0');
+        auto first = myBuffer.data() + myBufferPosition;
+        myBufferPosition += micro_parse_digits(
+          first, myBuffer.data() + myBufferLength, &value) - first;
+        c = next();
+      }
+      myInputColumns[fields * BLOCK_SIZE + count] =
+        static_cast<int64_t>(negative ? 0 - value : value);
+      ++fields;
+      comma = false;
+      separated = false;
+    }
+
+    if (comma)
+    {
+      throw malformed();
+    }
+    if (fields > 0)
+    {
+      if (fields != theFieldCount)
+      {
+        throw malformed();
+      }
+      ++count;
+    }
+    if (count < BLOCK_SIZE)
+    {
+      c = next();
+    }
+  }
+  return count;
+}
+
+//**************************************************
+// BatchMachine::run
+//**************************************************
+void BatchMachine::run(const Bytecode &theBytecode, std::FILE *theInput,
+                       std::FILE *theOutput)
+{
+  auto &operations = theBytecode.getOperations();
+  uint32_t inputFields = 0;
+  uint32_t outputFields = 0;
+  for (auto &operation : operations)
+  {
+    inputFields += (Bytecode::OpCode::Read == operation.myOpCode) ? 1 : 0;
+    outputFields += (Bytecode::OpCode::Write == operation.myOpCode) ? 1 : 0;
+  }
+  if (0 == inputFields)
+  {
+    throw std::runtime_error(
+      "Batch execution needs a program which reads its input.");
+  }
+
+  myInput = theInput;
+  myOutput = theOutput;
+  myBufferLength = 0;
+  myBufferPosition = 0;
+  myRecordCount = 0;
+  myInputColumns.assign(BLOCK_SIZE * inputFields, 0);
+  myOutputColumns.assign(BLOCK_SIZE * outputFields, 0);
+
+  // Each slot is a column; constants are the same in every record.
+  std::vector<int64_t> frame(BLOCK_SIZE * theBytecode.getFrameSize(), 0);
+  auto variables = frame.begin() + BLOCK_SIZE * theBytecode.getConstantBase();
+  for (auto constant : theBytecode.getConstants())
+  {
+    std::fill(variables, variables + BLOCK_SIZE, constant);
+    variables += BLOCK_SIZE;
+  }
+  auto column = [&](uint32_t theSlot)
+  {
+    return frame.data() + BLOCK_SIZE * theSlot;
+  };
+
+  for (;;)
+  {
+    auto count = readBlock(inputFields);
+    if (0 == count)
+    {
+      break;
+    }
+    std::fill(frame.begin(),
+              frame.begin() + BLOCK_SIZE * theBytecode.getConstantBase(), 0);
+
+    uint32_t reads = 0;
+    uint32_t writes = 0;
+    for (auto &operation : operations)
+    {
+      auto operands = operation.myOperands;
+      switch (operation.myOpCode)
+      {
+        case Bytecode::OpCode::Read:
+        {
+          auto source = &myInputColumns[BLOCK_SIZE * reads++];
+          std::copy(source, source + BLOCK_SIZE, column(operands[0]));
+        }
+        break;
+
+        case Bytecode::OpCode::Write:
+          std::copy(column(operands[0]), column(operands[0]) + BLOCK_SIZE,
+                    &myOutputColumns[BLOCK_SIZE * writes++]);
+          break;
+
+        case Bytecode::OpCode::Move:
+          std::copy(column(operands[0]), column(operands[0]) + BLOCK_SIZE,
+                    column(operands[1]));
+          break;
+
+        case Bytecode::OpCode::Add:
+          myAdd(column(operands[0]), column(operands[1]), column(operands[2]));
+          break;
+
+        case Bytecode::OpCode::Sub:
+          mySubtract(column(operands[0]), column(operands[1]),
+                     column(operands[2]));
+          break;
+
+        case Bytecode::OpCode::Mul:
+        {
+          // AVX2 has no 64 bit multiply.
+          auto left = column(operands[0]);
+          auto right = column(operands[1]);
+          auto result = column(operands[2]);
+          for (uint32_t ii = 0; ii < BLOCK_SIZE; ++ii)
+          {
+            result[ii] = static_cast<int64_t>(
+              static_cast<uint64_t>(left[ii]) *
+              static_cast<uint64_t>(right[ii]));
+          }
+        }
+        break;
+
+        case Bytecode::OpCode::Pow:
+        {
+          auto base = column(operands[0]);
+          auto exponent = column(operands[1]);
+          auto result = column(operands[2]);
+          for (uint32_t ii = 0; ii < count; ++ii)
+          {
+            result[ii] = micro_power(base[ii], exponent[ii]);
+          }
+        }
+        break;
+
+        case Bytecode::OpCode::Halt:
+          break;
+
+        default:
+          throw std::runtime_error(
+            std::string("Batch execution can't run ") +
+            Bytecode::getName(operation.myOpCode) + ".");
+      }
+      if (Bytecode::OpCode::Halt == operation.myOpCode)
+      {
+        break;
+      }
+    }
+
+    writeBlock(outputFields, count);
+    myRecordCount += count;
+    if (count < BLOCK_SIZE)
+    {
+      break;
+    }
+  }
+  std::fflush(myOutput);
+  myInput = nullptr;
+  myOutput = nullptr;
+}
+
+//**************************************************
+// BatchMachine::subtractScalar
+//**************************************************
+void BatchMachine::subtractScalar(const int64_t *theLeft,
+                                  const int64_t *theRight, int64_t *theResult)
+{
+  for (uint32_t ii = 0; ii < BLOCK_SIZE; ++ii)
+  {
+    theResult[ii] = static_cast<int64_t>(
+      static_cast<uint64_t>(theLeft[ii]) - static_cast<uint64_t>(theRight[ii]));
+  }
+}
+
+//**************************************************
+// BatchMachine::writeBlock
+//**************************************************
+void BatchMachine::writeBlock(uint32_t theFieldCount, uint32_t theRecordCount)
+{
+  if (0 == theFieldCount)
+  {
+    return;
+  }
+
+  if (myBinary)
+  {
+    std::vector<int64_t> records(theRecordCount * theFieldCount);
+    for (uint32_t record = 0; record < theRecordCount; ++record)
+    {
+      for (uint32_t field = 0; field < theFieldCount; ++field)
+      {
+        records[record * theFieldCount + field] =
+          myOutputColumns[field * BLOCK_SIZE + record];
+      }
+    }
+    std::fwrite(records.data(), sizeof(int64_t), records.size(), myOutput);
+    return;
+  }
+
+  std::string text;
+  text.reserve(theRecordCount * theFieldCount * 8);
+  char digits[20];
+  for (uint32_t record = 0; record < theRecordCount; ++record)
+  {
+    for (uint32_t field = 0; field < theFieldCount; ++field)
+    {
+      if (field > 0)
+      {
+        text.push_back(',');
+      }
+      auto end = digits + sizeof(digits);
+      text.append(
+        micro_format(myOutputColumns[field * BLOCK_SIZE + record], end), end);
+    }
+    text.push_back('\n');
+  }
+  std::fwrite(text.data(), 1, text.size(), myOutput);
+}
@@ -0,0 +1,243 @@
+#ifndef BATCHMACHINE_H
+#define BATCHMACHINE_H
+
+/**
+ * @file BatchMachine.h
+ * @brief Defines the interpreter which runs a program over many records.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+class Bytecode;
+
+/**
+ * Runs one program over every record of its input, a block of records at
+ * a time. Each variable is a column holding its value in every record of
+ * the block, and each operation is applied to whole columns, so the cost of
+ * dispatch is paid once per block rather than once per record. Add, Sub and
+ * Move use AVX2 (four records per instruction) when the processor has it,
+ * plain loops otherwise.
+ *
+ * A record is a run of the program: the n-th Read executed takes the
+ * record's n-th field, and the n-th Write executed gives the n-th field of
+ * the output record. Every run starts with the variables 0.
+ *
+ * As text, a record is a line of integers, each separated from the next
+ * by whitespace, a single comma or both (a field can't be empty; blank
+ * lines are skipped). As binary, a record is the native representation
+ * of its int64_t fields, back to back.
+ */
+class BatchMachine
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** Records run together. */
+  static constexpr uint32_t BLOCK_SIZE = 1024;
+
+  /**
+   * Default constructor.
+   */
+  BatchMachine() = delete;
+
+  /**
+   * Constructor.
+   *
+   * @param theBinary
+   *          records are binary (otherwise text)?
+   */
+  explicit BatchMachine(bool theBinary);
+
+  /**
+   * Copy constructor
+   */
+  BatchMachine(const BatchMachine &) = delete;
+
+  /**
+   * Move constructor
+   */
+  BatchMachine(BatchMachine &&) = delete;
+
+  /**
+   * Destructor
+   */
+  ~BatchMachine() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  BatchMachine& operator=(const BatchMachine &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  BatchMachine& operator=(BatchMachine &&) = delete;
+
+  /**
+   * Returns the number of records run by the last run.
+   *
+   * @return records
+   */
+  uint64_t getRecordCount() const noexcept;
+
+  /**
+   * Returns the number of records each vector instruction works on.
+   *
+   * @return 4 with AVX2, otherwise 1
+   */
+  uint32_t getVectorWidth() const noexcept;
+
+  /**
+   * Runs a program over every record of the input.
+   *
+   * @param theBytecode
+   *          program (unfused)
+   * @param theInput
+   *          input records
+   * @param theOutput
+   *          destination of output records
+   * @throws std::runtime_error
+   *           if the program doesn't read, or a record is malformed
+   */
+  void run(const Bytecode &theBytecode, std::FILE *theInput,
+           std::FILE *theOutput);
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Column operation: theResult[i] = theLeft[i] op theRight[i]. */
+  using Kernel = void (*)(const int64_t *theLeft, const int64_t *theRight,
+                          int64_t *theResult);
+
+  /**
+   * Adds columns with AVX2.
+   *
+   * @param theLeft
+   *          left operand column
+   * @param theRight
+   *          right operand column
+   * @param theResult
+   *          result column
+   */
+  static void addAvx2(const int64_t *theLeft, const int64_t *theRight,
+                      int64_t *theResult);
+
+  /**
+   * Adds columns.
+   *
+   * @param theLeft
+   *          left operand column
+   * @param theRight
+   *          right operand column
+   * @param theResult
+   *          result column
+   */
+  static void addScalar(const int64_t *theLeft, const int64_t *theRight,
+                        int64_t *theResult);
+
+  /**
+   * Returns the next input character, refilling the buffer as needed.
+   *
+   * @return character, or EOF
+   */
+  int next();
+
+  /**
+   * Reads the next block of records into the input columns.
+   *
+   * @param theFieldCount
+   *          fields per record
+   * @return number of records read (less than BLOCK_SIZE only at the end
+   *         of the input)
+   * @throws std::runtime_error
+   *           if a record is malformed
+   */
+  uint32_t readBlock(uint32_t theFieldCount);
+
+  /**
+   * Subtracts columns with AVX2.
+   *
+   * @param theLeft
+   *          left operand column
+   * @param theRight
+   *          right operand column
+   * @param theResult
+   *          result column
+   */
+  static void subtractAvx2(const int64_t *theLeft, const int64_t *theRight,
+                           int64_t *theResult);
+
+  /**
+   * Subtracts columns.
+   *
+   * @param theLeft
+   *          left operand column
+   * @param theRight
+   *          right operand column
+   * @param theResult
+   *          result column
+   */
+  static void subtractScalar(const int64_t *theLeft, const int64_t *theRight,
+                             int64_t *theResult);
+
+  /**
+   * Writes a block of records from the output columns.
+   *
+   * @param theFieldCount
+   *          fields per record
+   * @param theRecordCount
+   *          records in the block
+   */
+  void writeBlock(uint32_t theFieldCount, uint32_t theRecordCount);
+
+  /** Add kernel (AVX2 or scalar). */
+  Kernel myAdd;
+
+  /** Records are binary (otherwise text)? */
+  bool myBinary;
+
+  /** Input buffer. */
+  std::vector<char> myBuffer;
+
+  /** Bytes in myBuffer. */
+  std::size_t myBufferLength = 0;
+
+  /** Next byte of myBuffer to read. */
+  std::size_t myBufferPosition = 0;
+
+  /** Input stream of the current run. */
+  std::FILE *myInput = nullptr;
+
+  /** Input columns of the current block, one per field. */
+  std::vector<int64_t> myInputColumns;
+
+  /** Output columns of the current block, one per field. */
+  std::vector<int64_t> myOutputColumns;
+
+  /** Output stream of the current run. */
+  std::FILE *myOutput = nullptr;
+
+  /** Records run by the last run. */
+  uint64_t myRecordCount = 0;
+
+  /** Subtract kernel (AVX2 or scalar). */
+  Kernel mySubtract;
+
+  /** Records per vector instruction. */
+  uint32_t myVectorWidth;
+};
+
+#endif
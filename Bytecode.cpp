@@ -0,0 +1,282 @@
+/**
+ * @file Bytecode.cpp
+ * @brief Implementation of Bytecode class
+ *
+ * @author Michael Albers
+ */
+
+#include "Bytecode.h"
+#include "Program.h"
+
+constexpr uint32_t Bytecode::OPCODE_COUNT;
+
+//**************************************************
+// Bytecode::Bytecode
+//**************************************************
+Bytecode::Bytecode(const Program &theProgram, bool theChecked) :
+  myVariableCount(theProgram.getSymbolTable().size() +
+                  theProgram.getTemporaryCount() + 1),
+  mySymbolCount(theProgram.getSymbolTable().size())
+{
+  auto &instructions = theProgram.getInstructions();
+  myOperations.reserve(instructions.size() + 1);
+  myLines.reserve(instructions.size() + 1);
+  for (auto &instruction : instructions)
+  {
+    Operation operation{OpCode::Halt, {0, 0, 0}};
+    switch (instruction.getOpCode())
+    {
+      case Instruction::OpCode::Declare:
+        continue;
+
+      case Instruction::OpCode::Read:
+        operation.myOpCode = OpCode::Read;
+        break;
+
+      case Instruction::OpCode::Write:
+        operation.myOpCode = OpCode::Write;
+        break;
+
+      case Instruction::OpCode::Store:
+        operation.myOpCode = OpCode::Move;
+        break;
+
+      case Instruction::OpCode::Add:
+        operation.myOpCode = theChecked ? OpCode::CheckedAdd : OpCode::Add;
+        break;
+
+      case Instruction::OpCode::Sub:
+        operation.myOpCode = theChecked ? OpCode::CheckedSub : OpCode::Sub;
+        break;
+
+      case Instruction::OpCode::Mul:
+        operation.myOpCode = theChecked ? OpCode::CheckedMul : OpCode::Mul;
+        break;
+
+      case Instruction::OpCode::Pow:
+        operation.myOpCode = theChecked ? OpCode::CheckedPow : OpCode::Pow;
+        break;
+
+      case Instruction::OpCode::Halt:
+        operation.myOpCode = OpCode::Halt;
+        break;
+    }
+    auto operands = instruction.getSourceCount() +
+      (instruction.hasDestination() ? 1 : 0);
+    for (uint32_t ii = 0; ii < operands; ++ii)
+    {
+      operation.myOperands[ii] = slotOf(instruction.getOperand(ii));
+    }
+    myOperations.push_back(operation);
+    myLines.push_back(instruction.getLine());
+  }
+
+  if (myOperations.empty() || OpCode::Halt != myOperations.back().myOpCode)
+  {
+    myOperations.push_back(Operation{OpCode::Halt, {0, 0, 0}});
+    myLines.push_back(0);
+  }
+}
+
+//**************************************************
+// Bytecode::fuse
+//**************************************************
+void Bytecode::fuse()
+{
+  // Chosen from the opcode pairs run most over testCode and
+  // assignmentSubmissions. idList() makes runs of Reads and Writes; every
+  // expression ends in an Add or Sub, whose result is often Moved (at -O0)
+  // or Written straight after.
+  for (uint32_t ii = 0; ii + 1 < myOperations.size(); )
+  {
+    auto &operation = myOperations[ii];
+    auto &next = myOperations[ii + 1];
+    uint32_t covered = 1;
+    switch (operation.myOpCode)
+    {
+      case OpCode::Read:
+      case OpCode::Write:
+        while (ii + covered < myOperations.size() &&
+               operation.myOpCode == myOperations[ii + covered].myOpCode)
+        {
+          ++covered;
+        }
+        if (covered > 1)
+        {
+          operation.myOperands[1] = covered;
+          operation.myOpCode = (OpCode::Read == operation.myOpCode) ?
+            OpCode::ReadN : OpCode::WriteN;
+        }
+        break;
+
+      case OpCode::Add:
+      case OpCode::Sub:
+      {
+        auto isAdd = (OpCode::Add == operation.myOpCode);
+        if (OpCode::Move == next.myOpCode &&
+            operation.myOperands[2] == next.myOperands[0])
+        {
+          operation.myOpCode = isAdd ? OpCode::AddMove : OpCode::SubMove;
+          covered = 2;
+        }
+        else if (OpCode::Write == next.myOpCode &&
+                 operation.myOperands[2] == next.myOperands[0])
+        {
+          operation.myOpCode = isAdd ? OpCode::AddWrite : OpCode::SubWrite;
+          covered = 2;
+        }
+      }
+      break;
+
+      default:
+        break;
+    }
+    myFusedCount += covered - 1;
+    ii += covered;
+  }
+}
+
+//**************************************************
+// Bytecode::getConstantBase
+//**************************************************
+uint32_t Bytecode::getConstantBase() const noexcept
+{
+  return myVariableCount;
+}
+
+//**************************************************
+// Bytecode::getConstants
+//**************************************************
+const std::vector<int64_t>& Bytecode::getConstants() const noexcept
+{
+  return myConstants;
+}
+
+//**************************************************
+// Bytecode::getFrameSize
+//**************************************************
+uint32_t Bytecode::getFrameSize() const noexcept
+{
+  return myVariableCount + myConstants.size();
+}
+
+//**************************************************
+// Bytecode::getFusedCount
+//**************************************************
+uint32_t Bytecode::getFusedCount() const noexcept
+{
+  return myFusedCount;
+}
+
+//**************************************************
+// Bytecode::getLines
+//**************************************************
+const std::vector<uint32_t>& Bytecode::getLines() const noexcept
+{
+  return myLines;
+}
+
+//**************************************************
+// Bytecode::getName
+//**************************************************
+const char* Bytecode::getName(OpCode theOpCode) noexcept
+{
+  switch (theOpCode)
+  {
+    case OpCode::Read:
+      return "Read";
+
+    case OpCode::Write:
+      return "Write";
+
+    case OpCode::Move:
+      return "Move";
+
+    case OpCode::Add:
+      return "Add";
+
+    case OpCode::Sub:
+      return "Sub";
+
+    case OpCode::Mul:
+      return "Mul";
+
+    case OpCode::Pow:
+      return "Pow";
+
+    case OpCode::Halt:
+      return "Halt";
+
+    case OpCode::ReadN:
+      return "ReadN";
+
+    case OpCode::WriteN:
+      return "WriteN";
+
+    case OpCode::AddMove:
+      return "AddMove";
+
+    case OpCode::SubMove:
+      return "SubMove";
+
+    case OpCode::AddWrite:
+      return "AddWrite";
+
+    case OpCode::SubWrite:
+      return "SubWrite";
+
+    case OpCode::CheckedAdd:
+      return "CheckedAdd";
+
+    case OpCode::CheckedSub:
+      return "CheckedSub";
+
+    case OpCode::CheckedMul:
+      return "CheckedMul";
+
+    case OpCode::CheckedPow:
+      return "CheckedPow";
+  }
+  return "?";
+}
+
+//**************************************************
+// Bytecode::getOperations
+//**************************************************
+const std::vector<Bytecode::Operation>& Bytecode::getOperations()
+  const noexcept
+{
+  return myOperations;
+}
+
+//**************************************************
+// Bytecode::slotOf
+//**************************************************
+uint32_t Bytecode::slotOf(const Operand &theOperand)
+{
+  switch (theOperand.getKind())
+  {
+    case Operand::Kind::Symbol:
+      return theOperand.getIndex();
+
+    case Operand::Kind::Temporary:
+      return mySymbolCount + theOperand.getIndex();
+
+    case Operand::Kind::Literal:
+    {
+      auto value = theOperand.getValue();
+      auto slot = myConstantSlots.find(value);
+      if (myConstantSlots.end() != slot)
+      {
+        return slot->second;
+      }
+      uint32_t newSlot = myVariableCount + myConstants.size();
+      myConstants.push_back(value);
+      myConstantSlots.emplace(value, newSlot);
+      return newSlot;
+    }
+
+    default:
+      return 0;
+  }
+}
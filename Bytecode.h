@@ -0,0 +1,230 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+/**
+ * @file Bytecode.h
+ * @brief Defines the compact encoding of programs run by VirtualMachine.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Operand;
+class Program;
+
+/**
+ * A program encoded for interpretation. Every operation is the same size:
+ * an opcode and up to three operands, each a frame slot index. The frame
+ * holds the symbols, then the temporaries, then the constant pool (each
+ * distinct literal once), so the interpreter never looks at an operand's
+ * kind or a name: every access is an array index.
+ *
+ * Operands are in the same order as in the intermediate code (sources,
+ * then the destination). Declare isn't encoded.
+ *
+ * fuse() replaces common sequences of operations with superinstructions,
+ * which do the work of the whole sequence in one dispatch. A
+ * superinstruction takes the place of the first operation of its sequence
+ * and reads any further operands from the operations it covers, which are
+ * left in place (and skipped), so operations never move.
+ *
+ * Checked programs (--checked) use the Checked forms of the arithmetic
+ * operations, which stop the program on a signed overflow. The source line
+ * of each operation is kept alongside it (see getLines) for the report.
+ */
+class Bytecode
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** Operation codes. */
+  enum class OpCode : uint32_t
+  {
+    Read,
+    Write,
+    Move,
+    Add,
+    Sub,
+    Mul,
+    Pow,
+    Halt,
+    // Superinstructions.
+    /** Read into each of the next myOperands[1] Reads' operands. */
+    ReadN,
+    /** Write each of the next myOperands[1] Writes' operands. */
+    WriteN,
+    /** Add, then Move the result. */
+    AddMove,
+    /** Sub, then Move the result. */
+    SubMove,
+    /** Add, then Write the result. */
+    AddWrite,
+    /** Sub, then Write the result. */
+    SubWrite,
+    // Checked arithmetic.
+    CheckedAdd,
+    CheckedSub,
+    CheckedMul,
+    CheckedPow
+  };
+
+  /** Number of operation codes. */
+  static constexpr uint32_t OPCODE_COUNT =
+    static_cast<uint32_t>(OpCode::CheckedPow) + 1;
+
+  /** One operation. */
+  struct Operation
+  {
+    /** What it does. */
+    OpCode myOpCode;
+
+    /** Frame slots operated on (unused ones are 0). */
+    uint32_t myOperands[3];
+  };
+
+  /**
+   * Default constructor.
+   */
+  Bytecode() = delete;
+
+  /**
+   * Constructor. Encodes a program.
+   *
+   * @param theProgram
+   *          program to encode
+   * @param theChecked
+   *          stop on signed overflow (rather than wrap)?
+   */
+  Bytecode(const Program &theProgram, bool theChecked);
+
+  /**
+   * Copy constructor
+   */
+  Bytecode(const Bytecode &) = default;
+
+  /**
+   * Move constructor
+   */
+  Bytecode(Bytecode &&) = default;
+
+  /**
+   * Destructor
+   */
+  ~Bytecode() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  Bytecode& operator=(const Bytecode &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  Bytecode& operator=(Bytecode &&) = default;
+
+  /**
+   * Replaces sequences of operations with superinstructions.
+   */
+  void fuse();
+
+  /**
+   * Returns the constant pool.
+   *
+   * @return constants, in slot order
+   */
+  const std::vector<int64_t>& getConstants() const noexcept;
+
+  /**
+   * Returns the frame slot of the first constant.
+   *
+   * @return first constant slot (also the number of variables)
+   */
+  uint32_t getConstantBase() const noexcept;
+
+  /**
+   * Returns the number of slots in the frame.
+   *
+   * @return frame size, in 64 bit slots
+   */
+  uint32_t getFrameSize() const noexcept;
+
+  /**
+   * Returns the number of operations covered by superinstructions (not
+   * counting the superinstructions themselves), i.e., the number of
+   * dispatches saved each time they all run.
+   *
+   * @return operations fused
+   */
+  uint32_t getFusedCount() const noexcept;
+
+  /**
+   * Returns the source line of each operation.
+   *
+   * @return lines, one per operation (0 where there is no source)
+   */
+  const std::vector<uint32_t>& getLines() const noexcept;
+
+  /**
+   * Returns the operations. The last is always Halt.
+   *
+   * @return operations
+   */
+  const std::vector<Operation>& getOperations() const noexcept;
+
+  /**
+   * Returns the name of an operation code.
+   *
+   * @param theOpCode
+   *          operation code
+   * @return name
+   */
+  static const char* getName(OpCode theOpCode) noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Returns the frame slot of an operand, adding literals to the constant
+   * pool.
+   *
+   * @param theOperand
+   *          operand
+   * @return slot
+   */
+  uint32_t slotOf(const Operand &theOperand);
+
+  /** Number of operations covered by superinstructions. */
+  uint32_t myFusedCount = 0;
+
+  /** Constant pool. */
+  std::vector<int64_t> myConstants;
+
+  /** Slot of each constant in the pool. */
+  std::unordered_map<int64_t, uint32_t> myConstantSlots;
+
+  /** Source line of each operation. */
+  std::vector<uint32_t> myLines;
+
+  /** Number of variable slots (symbols, then temporaries). */
+  uint32_t myVariableCount;
+
+  /** Number of symbols in the program. */
+  uint32_t mySymbolCount;
+
+  /** The encoded program. */
+  std::vector<Operation> myOperations;
+};
+
+#endif
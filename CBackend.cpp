@@ -0,0 +1,410 @@
+/**
+ * @file CBackend.cpp
+ * @brief Implementation of CBackend class
+ *
+ * @author Michael Albers
+ */
+
+#include <vector>
+
+#include "CBackend.h"
+#include "Instruction.h"
+#include "OutputSink.h"
+#include "Program.h"
+
+const char *CBackend::RUNTIME_OUTPUT =
+  "static char micro_output[1 << 16];\n"
+  "static size_t micro_output_length;\n"
+  "\n"
+  "static void micro_flush(void)\n"
+  "{\n"
+  "  fwrite(micro_output, 1, micro_output_length, stdout);\n"
+  "  fflush(stdout);\n"
+  "  micro_output_length = 0;\n"
+  "}\n"
+  "\n";
+
+const char *CBackend::RUNTIME_READ =
+  "static char micro_input[1 << 16];\n"
+  "static size_t micro_input_position;\n"
+  "static size_t micro_input_length;\n"
+  "\n"
+  "static int micro_next(void)\n"
+  "{\n"
+  "  if (micro_input_position == micro_input_length)\n"
+  "  {\n"
+  "    micro_input_length = fread(micro_input, 1, sizeof micro_input,"
+  " stdin);\n"
+  "    micro_input_position = 0;\n"
+  "    if (0 == micro_input_length)\n"
+  "    {\n"
+  "      return EOF;\n"
+  "    }\n"
+  "  }\n"
+  "  return (unsigned char)micro_input[micro_input_position++];\n"
+  "}\n"
+  "\n"
+  "static int micro_peek(void)\n"
+  "{\n"
+  "  int c = micro_next();\n"
+  "  if (EOF != c)\n"
+  "  {\n"
+  "    --micro_input_position;\n"
+  "  }\n"
+  "  return c;\n"
+  "}\n"
+  "\n"
+  "static int64_t micro_read(void)\n"
+  "{\n"
+  "  int c;\n"
+  "  int negative;\n"
+  "  uint64_t value;\n"
+  "  do\n"
+  "  {\n"
+  "    c = micro_next();\n"
+  "  } while (' ' == c || '\\t' == c || '\\n' == c || '\\r' == c ||\n"
+  "           '\\v' == c || '\\f' == c);\n"
+  "  negative = ('-' == c);\n"
+  "  if ('-' == c || '+' == c)\n"
+  "  {\n"
+  "    c = micro_next();\n"
+  "  }\n"
+  "  if (c < '0' || c > '9')\n"
+  "  {\n"
+  "    micro_flush();\n"
+  "    fputs(\"error: expected an integer on input\\n\", stderr);\n"
+  "    exit(1);\n"
+  "  }\n"
+  "  value = (uint64_t)(c - '0');\n"
+  "  for (c = micro_peek(); c >= '0' && c <= '9'; c = micro_peek())\n"
+  "  {\n"
+  "    value = value * 10 + (uint64_t)(c - '0');\n"
+  "    ++micro_input_position;\n"
+  "  }\n"
+  "  return (int64_t)(negative ? 0 - value : value);\n"
+  "}\n"
+  "\n";
+
+const char *CBackend::RUNTIME_WRITE =
+  "static void micro_write(int64_t value)\n"
+  "{\n"
+  "  char digits[20];\n"
+  "  int count = 0;\n"
+  "  uint64_t magnitude = (value < 0) ? 0 - (uint64_t)value :"
+  " (uint64_t)value;\n"
+  "  if (micro_output_length + 22 > sizeof micro_output)\n"
+  "  {\n"
+  "    micro_flush();\n"
+  "  }\n"
+  "  do\n"
+  "  {\n"
+  "    digits[count++] = (char)('0' + magnitude % 10);\n"
+  "    magnitude /= 10;\n"
+  "  } while (0 != magnitude);\n"
+  "  if (value < 0)\n"
+  "  {\n"
+  "    micro_output[micro_output_length++] = '-';\n"
+  "  }\n"
+  "  while (count > 0)\n"
+  "  {\n"
+  "    micro_output[micro_output_length++] = digits[--count];\n"
+  "  }\n"
+  "  micro_output[micro_output_length++] = '\\n';\n"
+  "}\n"
+  "\n";
+
+const char *CBackend::RUNTIME_POWER =
+  "static int64_t micro_power(int64_t base, int64_t exponent)\n"
+  "{\n"
+  "  uint64_t result = 1;\n"
+  "  uint64_t square = (uint64_t)base;\n"
+  "  uint64_t bits = (uint64_t)exponent;\n"
+  "  if (exponent < 0)\n"
+  "  {\n"
+  "    if (1 == base || -1 == base)\n"
+  "    {\n"
+  "      return (exponent & 1) ? base : 1;\n"
+  "    }\n"
+  "    return 0;\n"
+  "  }\n"
+  "  for (; 0 != bits; bits >>= 1)\n"
+  "  {\n"
+  "    if (bits & 1)\n"
+  "    {\n"
+  "      result *= square;\n"
+  "    }\n"
+  "    square *= square;\n"
+  "  }\n"
+  "  return (int64_t)result;\n"
+  "}\n"
+  "\n";
+
+const char *CBackend::RUNTIME_POWER_CHECKED =
+  "static int64_t micro_power_checked(int64_t base, int64_t exponent,\n"
+  "                                   unsigned line)\n"
+  "{\n"
+  "  int64_t result = 1;\n"
+  "  int64_t square = base;\n"
+  "  uint64_t bits = (uint64_t)exponent;\n"
+  "  if (exponent < 0)\n"
+  "  {\n"
+  "    if (0 == base)\n"
+  "    {\n"
+  "      micro_flush();\n"
+  "      fprintf(stderr, \"error: zero to a negative power on line %u\\n\",\n"
+  "              line);\n"
+  "      exit(1);\n"
+  "    }\n"
+  "    if (1 == base || -1 == base)\n"
+  "    {\n"
+  "      return (exponent & 1) ? base : 1;\n"
+  "    }\n"
+  "    return 0;\n"
+  "  }\n"
+  "  while (0 != bits)\n"
+  "  {\n"
+  "    if ((bits & 1) && __builtin_mul_overflow(result, square, &result))\n"
+  "    {\n"
+  "      micro_overflow(line);\n"
+  "    }\n"
+  "    bits >>= 1;\n"
+  "    if (0 != bits && __builtin_mul_overflow(square, square, &square))\n"
+  "    {\n"
+  "      micro_overflow(line);\n"
+  "    }\n"
+  "  }\n"
+  "  return result;\n"
+  "}\n"
+  "\n";
+
+const char *CBackend::RUNTIME_OVERFLOW =
+  "static void micro_overflow(unsigned line)\n"
+  "{\n"
+  "  micro_flush();\n"
+  "  fprintf(stderr, \"error: integer overflow on line %u\\n\", line);\n"
+  "  exit(1);\n"
+  "}\n"
+  "\n";
+
+//**************************************************
+// CBackend::CBackend
+//**************************************************
+CBackend::CBackend(bool theChecked) :
+  myChecked(theChecked)
+{
+}
+
+//**************************************************
+// CBackend::emit
+//**************************************************
+void CBackend::emit(const Program &theProgram, OutputSink &theSink)
+{
+  auto &instructions = theProgram.getInstructions();
+  const uint32_t symbolCount = theProgram.getSymbolTable().size();
+
+  // Only variables read and runtime routines used are written, so the
+  // result compiles cleanly with warnings on. Assignments to variables
+  // never read are dropped (keeping the input a Read consumes).
+  std::vector<bool> used(symbolCount + theProgram.getTemporaryCount() + 1,
+                         false);
+  auto isUsed = [&](const Operand &theOperand)
+  {
+    return used[(Operand::Kind::Temporary == theOperand.getKind() ?
+                 symbolCount : 0) + theOperand.getIndex()];
+  };
+  bool reads = false;
+  bool writes = false;
+  bool powers = false;
+  bool arithmetic = false;
+  for (auto &instruction : instructions)
+  {
+    reads = reads || Instruction::OpCode::Read == instruction.getOpCode();
+    writes = writes || Instruction::OpCode::Write == instruction.getOpCode();
+    powers = powers || Instruction::OpCode::Pow == instruction.getOpCode();
+    arithmetic = arithmetic || isArithmetic(instruction.getOpCode());
+    for (uint32_t ii = 0; ii < instruction.getSourceCount(); ++ii)
+    {
+      auto &operand = instruction.getOperand(ii);
+      if (Operand::Kind::Symbol == operand.getKind())
+      {
+        used[operand.getIndex()] = true;
+      }
+      else if (Operand::Kind::Temporary == operand.getKind())
+      {
+        used[symbolCount + operand.getIndex()] = true;
+      }
+    }
+  }
+
+  theSink.write("/* Generated by MicroCompiler. */\n"
+                "\n"
+                "#include <stdint.h>\n"
+                "#include <stdio.h>\n"
+                "#include <stdlib.h>\n"
+                "\n");
+  theSink.write(RUNTIME_OUTPUT);
+  if (reads)
+  {
+    theSink.write(RUNTIME_READ);
+  }
+  if (writes)
+  {
+    theSink.write(RUNTIME_WRITE);
+  }
+  if (myChecked && arithmetic)
+  {
+    theSink.write(RUNTIME_OVERFLOW);
+  }
+  if (powers)
+  {
+    theSink.write(myChecked ? RUNTIME_POWER_CHECKED : RUNTIME_POWER);
+  }
+
+  theSink.write("int main(void)\n"
+                "{\n");
+  for (uint32_t ii = 0; ii < used.size(); ++ii)
+  {
+    if (used[ii])
+    {
+      auto variable = (ii < symbolCount) ?
+        Operand(Operand::Kind::Symbol, ii) :
+        Operand(Operand::Kind::Temporary, ii - symbolCount);
+      theSink.write("  int64_t " + expression(theProgram, variable) +
+                    " = 0;\n");
+    }
+  }
+
+  bool halted = false;
+  for (auto &instruction : instructions)
+  {
+    auto operand = [&](uint32_t theIndex)
+    {
+      return expression(theProgram, instruction.getOperand(theIndex));
+    };
+
+    // Checked arithmetic must still run for its overflow check.
+    auto opCode = instruction.getOpCode();
+    auto isDead = instruction.hasDestination() &&
+      ! isUsed(instruction.getDestination());
+    if (isDead && ! (myChecked && isArithmetic(opCode)))
+    {
+      if (Instruction::OpCode::Read == opCode)
+      {
+        theSink.write("  (void)micro_read();\n");
+      }
+      continue;
+    }
+    auto lineNumber = std::to_string(instruction.getLine()) + "u";
+
+    std::string line;
+    switch (opCode)
+    {
+      case Instruction::OpCode::Declare:
+        continue;
+
+      case Instruction::OpCode::Read:
+        line = operand(0) + " = micro_read();";
+        break;
+
+      case Instruction::OpCode::Write:
+        line = "micro_write(" + operand(0) + ");";
+        break;
+
+      case Instruction::OpCode::Store:
+        line = operand(1) + " = " + operand(0) + ";";
+        break;
+
+      case Instruction::OpCode::Add:
+      case Instruction::OpCode::Sub:
+      case Instruction::OpCode::Mul:
+      {
+        if (myChecked)
+        {
+          const char *builtin = (Instruction::OpCode::Add == opCode) ? "add" :
+            (Instruction::OpCode::Sub == opCode) ? "sub" : "mul";
+          line = "if (__builtin_" + std::string(builtin) + "_overflow(" +
+            operand(0) + ", " + operand(1) + ", &" +
+            (isDead ? std::string("(int64_t){0}") : operand(2)) +
+            "))\n  {\n    micro_overflow(" + lineNumber + ");\n  }";
+          break;
+        }
+        const char *op = (Instruction::OpCode::Add == opCode) ? " + " :
+          (Instruction::OpCode::Sub == opCode) ? " - " : " * ";
+        line = operand(2) + " = (int64_t)((uint64_t)" + operand(0) + op +
+          "(uint64_t)" + operand(1) + ");";
+      }
+      break;
+
+      case Instruction::OpCode::Pow:
+        if (myChecked)
+        {
+          line = (isDead ? std::string("(void)") : operand(2) + " = ") +
+            "micro_power_checked(" + operand(0) + ", " + operand(1) + ", " +
+            lineNumber + ");";
+          break;
+        }
+        line = operand(2) + " = micro_power(" + operand(0) + ", " +
+          operand(1) + ");";
+        break;
+
+      case Instruction::OpCode::Halt:
+        line = "micro_flush();\n  return 0;";
+        halted = true;
+        break;
+    }
+    theSink.write("  " + line + "\n");
+  }
+
+  if (! halted)
+  {
+    theSink.write("  micro_flush();\n"
+                  "  return 0;\n");
+  }
+  theSink.write("}\n");
+}
+
+//**************************************************
+// CBackend::expression
+//**************************************************
+std::string CBackend::expression(const Program &theProgram,
+                                 const Operand &theOperand)
+{
+  switch (theOperand.getKind())
+  {
+    case Operand::Kind::Symbol:
+      return "v_" + theProgram.getSymbolTable().getSymbol(
+        theOperand.getIndex());
+
+    case Operand::Kind::Temporary:
+      return "t_" + std::to_string(theOperand.getIndex());
+
+    case Operand::Kind::Literal:
+      // The magnitude of INT64_MIN doesn't fit, so it can't be negated.
+      if (INT64_MIN == theOperand.getValue())
+      {
+        return "INT64_MIN";
+      }
+      return "INT64_C(" + std::to_string(theOperand.getValue()) + ")";
+
+    default:
+      return "0";
+  }
+}
+
+//**************************************************
+// CBackend::isArithmetic
+//**************************************************
+bool CBackend::isArithmetic(Instruction::OpCode theOpCode) noexcept
+{
+  switch (theOpCode)
+  {
+    case Instruction::OpCode::Add:
+    case Instruction::OpCode::Sub:
+    case Instruction::OpCode::Mul:
+    case Instruction::OpCode::Pow:
+      return true;
+
+    default:
+      return false;
+  }
+}
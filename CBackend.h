@@ -0,0 +1,144 @@
+#ifndef CBACKEND_H
+#define CBACKEND_H
+
+/**
+ * @file CBackend.h
+ * @brief Defines the class which writes programs as C source.
+ *
+ * @author Michael Albers
+ */
+
+#include <string>
+
+#include "Instruction.h"
+
+class Operand;
+class OutputSink;
+class Program;
+
+/**
+ * Writes a program as a self-contained C translation unit, to be compiled
+ * by the system compiler:
+ *
+ *   MicroCompiler -q -t c -o prog.c prog.mc
+ *   cc -O2 -o prog prog.c
+ *
+ * Every variable becomes an int64_t local of main, initially 0 (symbols are
+ * named v_NAME, temporaries t_N, so they can't clash with C keywords or the
+ * runtime). Arithmetic is done in uint64_t and converted back, so overflow
+ * wraps as in the other backends rather than being undefined behavior.
+ * Read and Write call a small buffered I/O runtime written out with the
+ * program (only the parts the program uses).
+ *
+ * Checked code (--checked) uses __builtin_add_overflow and friends instead,
+ * stopping with the source line on a signed overflow.
+ */
+class CBackend
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  CBackend() = delete;
+
+  /**
+   * Constructor.
+   *
+   * @param theChecked
+   *          stop on signed overflow (rather than wrap)?
+   */
+  explicit CBackend(bool theChecked);
+
+  /**
+   * Copy constructor
+   */
+  CBackend(const CBackend &) = delete;
+
+  /**
+   * Move constructor
+   */
+  CBackend(CBackend &&) = delete;
+
+  /**
+   * Destructor
+   */
+  ~CBackend() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  CBackend& operator=(const CBackend &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  CBackend& operator=(CBackend &&) = delete;
+
+  /**
+   * Writes the program.
+   *
+   * @param theProgram
+   *          program to write
+   * @param theSink
+   *          destination
+   */
+  void emit(const Program &theProgram, OutputSink &theSink);
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Runtime support always needed (output buffer and flush). */
+  static const char *RUNTIME_OUTPUT;
+
+  /** Runtime support for Read (as micro_read in Runtime.cpp). */
+  static const char *RUNTIME_READ;
+
+  /** Runtime support for Write. */
+  static const char *RUNTIME_WRITE;
+
+  /** Runtime support for Pow. */
+  static const char *RUNTIME_POWER;
+
+  /** Runtime support for checked Pow (after RUNTIME_OVERFLOW). */
+  static const char *RUNTIME_POWER_CHECKED;
+
+  /** Runtime support for checked arithmetic. */
+  static const char *RUNTIME_OVERFLOW;
+
+  /**
+   * Returns the C expression for an operand.
+   *
+   * @param theProgram
+   *          program containing the operand
+   * @param theOperand
+   *          operand
+   * @return variable name or constant
+   */
+  static std::string expression(const Program &theProgram,
+                                const Operand &theOperand);
+
+  /**
+   * Returns if an operation is arithmetic (so can overflow).
+   *
+   * @param theOpCode
+   *          operation
+   * @return true for Add, Sub, Mul and Pow
+   */
+  static bool isArithmetic(Instruction::OpCode theOpCode) noexcept;
+
+  /** Stop on signed overflow? */
+  bool myChecked;
+};
+
+#endif
@@ -5,121 +5,249 @@
  * @author Michael Albers
  */
 
-#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
-#include <sstream>
+#include <memory>
+#include <utility>
+#include <vector>
 
+#include "BatchMachine.h"
+#include "Bytecode.h"
+#include "CBackend.h"
 #include "CodeGenerator.h"
+#include "CompileTimeEvaluation.h"
+#include "CompilerOptions.h"
+#include "CopyPropagation.h"
+#include "DeadCodeElimination.h"
 #include "ErrorWarningTracker.h"
 #include "ExpressionRecord.h"
+#include "JitBackend.h"
+#include "ObjectFile.h"
 #include "OperatorRecord.h"
+#include "OutputSink.h"
+#include "Peephole.h"
+#include "Reassociation.h"
+#include "Runtime.h"
+#include "StrengthReduction.h"
+#include "TemporaryAllocation.h"
+#include "TextBackend.h"
+#include "Token.h"
+#include "ValueNumbering.h"
+#include "VirtualMachine.h"
+#include "X86Backend.h"
 
 //**************************************************
 // CodeGenerator::CodeGenerator
 //**************************************************
-CodeGenerator::CodeGenerator(ErrorWarningTracker &theEWTracker) :
-  myEWTracker(theEWTracker)
+CodeGenerator::CodeGenerator(OutputSink &theSink,
+                             ErrorWarningTracker &theEWTracker,
+                             const CompilerOptions &theOptions) :
+  myEWTracker(theEWTracker),
+  myOptions(theOptions),
+  mySink(theSink)
 {
 }
 
-//**************************************************
-// CodeGenerator::~CodeGenerator
-//**************************************************
-CodeGenerator::~CodeGenerator()
-{
-  std::cout << std::endl
-            << "Complete Code" << std::endl
-            << "-------------" << std::endl
-            << myGeneratedCode;
-}
-
 //**************************************************
 // CodeGenerator::assign
 //**************************************************
 void CodeGenerator::assign(const ExpressionRecord &theSource,
                            const ExpressionRecord &theDestination) noexcept
 {
-  std::cout << "Call assign" << std::endl;
-  generate("Store", theSource.getValue(), theDestination.getValue());
+  trace("assign");
+
+  // If the expression's final operation was the last instruction generated
+  // it can write straight into the destination, no Store needed. Nothing
+  // later in the expression can read the destination (the final operation
+  // reads its sources before writing).
+  auto source = toOperand(theSource);
+  auto destination = toOperand(theDestination);
+  myExpressions.assign(destination);
+  auto &instructions = myProgram.getInstructions();
+  if (! myEWTracker.hasError() &&
+      Operand::Kind::Temporary == source.getKind() &&
+      ! instructions.empty() &&
+      instructions.back().hasDestination() &&
+      instructions.back().getDestination() == source)
+  {
+    instructions.back().setDestination(destination);
+    myStatistics.add("assignments computed directly into their target");
+    if (myOptions.isTraceEnabled())
+    {
+      printCode("(result redirected to " + theDestination.getValue() + ")\n");
+    }
+    // The destination now holds the expression's value, the temporary
+    // never does.
+    if (ExpressionRecord::Type::Node == theSource.getType())
+    {
+      myExpressions.setResult(theSource.getIndex(), destination);
+    }
+    return;
+  }
+
+  generate(Instruction(Instruction::OpCode::Store, source, destination));
 }
 
 //**************************************************
 // CodeGenerator::checkId
 //**************************************************
-void CodeGenerator::checkId(const std::string &theIdentifier) noexcept
+uint32_t CodeGenerator::checkId(const std::string &theIdentifier,
+                                uint64_t theHash) noexcept
 {
-  std::cout << "Call checkId" << std::endl;
-  if (false == lookUp(theIdentifier))
+  trace("checkId");
+  auto index = myProgram.getSymbolTable().find(theIdentifier, theHash);
+  if (SymbolTable::NOT_FOUND == index)
   {
-    enter(theIdentifier);
-    generate("Declare", theIdentifier, "Integer");
+    index = enter(theIdentifier, theHash);
+    generate(Instruction(Instruction::OpCode::Declare,
+                         Operand(Operand::Kind::Symbol, index)));
   }
+  return index;
 }
 
 //**************************************************
 // CodeGenerator::enter
 //**************************************************
-void CodeGenerator::enter(const std::string theIdentifier) noexcept
+uint32_t CodeGenerator::enter(const std::string &theIdentifier,
+                              uint64_t theHash) noexcept
 {
-  mySymbolTable.push_back(theIdentifier);
+  return myProgram.getSymbolTable().insert(theIdentifier, theHash);
 }
 
 //**************************************************
-// CodeGenerator::finish
+// CodeGenerator::execute
 //**************************************************
-void CodeGenerator::finish()
+void CodeGenerator::execute()
 {
-  std::cout << "Call finish" << std::endl;
-  generate("Halt");
-}
+  using Clock = std::chrono::steady_clock;
+  auto microseconds = [](Clock::time_point theStart)
+  {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+      Clock::now() - theStart).count();
+  };
 
-//**************************************************
-// CodeGenerator::generate
-//**************************************************
-void CodeGenerator::generate(const std::string &theInstruction) noexcept
-{
-  if (! myEWTracker.hasError())
+  switch (myOptions.getExecution())
   {
-    std::ostringstream code;
-    code << theInstruction << std::endl;
-    printCode(code.str());
-    myGeneratedCode += code.str();
+    case CompilerOptions::Execution::None:
+      break;
+
+    case CompilerOptions::Execution::Jit:
+    {
+      JitBackend jit;
+      auto start = Clock::now();
+      jit.compile(myProgram, myOptions.isChecked());
+      myStatistics.add("JIT compile time (us)", microseconds(start));
+      myStatistics.add("JIT code bytes", jit.getCodeSize());
+      start = Clock::now();
+      jit.run(JitBackend::getRuntimeCallbacks());
+      myStatistics.add("run time (us)", microseconds(start));
+    }
+    break;
+
+    case CompilerOptions::Execution::Vm:
+    {
+      Bytecode bytecode(myProgram, myOptions.isChecked());
+      if (myOptions.isSuperinstructionsEnabled())
+      {
+        bytecode.fuse();
+      }
+      myStatistics.add("bytecode operations",
+                       bytecode.getOperations().size());
+      myStatistics.add("bytecode operations fused", bytecode.getFusedCount());
+      myStatistics.add("bytecode constants", bytecode.getConstants().size());
+      VirtualMachine vm;
+      auto start = Clock::now();
+      vm.run(bytecode);
+      myStatistics.add("run time (us)", microseconds(start));
+      myStatistics.add("VM dispatches", vm.getDispatchCount());
+      myStatistics.add("VM dispatches saved by superinstructions",
+                       vm.getSavedDispatchCount());
+    }
+    break;
+
+    case CompilerOptions::Execution::Batch:
+    {
+      Bytecode bytecode(myProgram, myOptions.isChecked());
+      BatchMachine batch(myOptions.isBatchBinary());
+      auto start = Clock::now();
+      batch.run(bytecode, stdin, stdout);
+      myStatistics.add("run time (us)", microseconds(start));
+      myStatistics.add("batch records", batch.getRecordCount());
+      myStatistics.add("batch vector width", batch.getVectorWidth());
+    }
+    break;
   }
+  micro_flush();
 }
 
 //**************************************************
-// CodeGenerator::generate
+// CodeGenerator::finish
 //**************************************************
-void CodeGenerator::generate(const std::string &theInstruction,
-                             const std::string &theFirst,
-                             const std::string &theSecond) noexcept
+void CodeGenerator::finish()
 {
+  trace("finish");
+  generate(Instruction(Instruction::OpCode::Halt));
+
+  // Anything generated before an error is still written, but it isn't
+  // worth optimizing.
   if (! myEWTracker.hasError())
   {
-    std::ostringstream code;
-    code << theInstruction << " " << theFirst << ", " << theSecond
-         << std::endl;
-    printCode(code.str());
-    myGeneratedCode += code.str();
+    optimize();
+  }
+
+  myStatistics.add("expression DAG lookups", myExpressions.getLookupCount());
+  myStatistics.add("expression DAG nodes", myExpressions.getNodeCount());
+
+  switch (myOptions.getTarget())
+  {
+    case CompilerOptions::Target::Text:
+    {
+      TextBackend backend;
+      backend.emit(myProgram, mySink);
+    }
+    break;
+
+    case CompilerOptions::Target::X86_64:
+    {
+      X86Backend backend(myOptions.isChecked(), myOptions.getInstrument(),
+                         myOptions.getInputFile());
+      backend.emit(myProgram, mySink, myStatistics);
+    }
+    break;
+
+    case CompilerOptions::Target::C:
+    {
+      CBackend backend(myOptions.isChecked());
+      backend.emit(myProgram, mySink);
+    }
+    break;
+  }
+
+  if (! myOptions.getObjectFile().empty() && ! myEWTracker.hasError())
+  {
+    writeObject();
   }
 }
 
 //**************************************************
 // CodeGenerator::generate
 //**************************************************
-void CodeGenerator::generate(const std::string &theInstruction,
-                             const std::string &theFirst,
-                             const std::string &theSecond,
-                             const std::string &theThird) noexcept
+void CodeGenerator::generate(const Instruction &theInstruction) noexcept
 {
   if (! myEWTracker.hasError())
   {
-    std::ostringstream code;
-    code << theInstruction << " " << theFirst << ", " << theSecond << ", "
-         << theThird << std::endl;
-    printCode(code.str());
-    myGeneratedCode += code.str();
+    myProgram.append(theInstruction);
+    myProgram.getInstructions().back().setLine(myLine);
+    if (myOptions.isTraceEnabled())
+    {
+      std::string code;
+      TextBackend::format(myProgram, theInstruction, code);
+      code.push_back('\n');
+      printCode(code);
+    }
   }
 }
 
@@ -131,37 +259,160 @@ ExpressionRecord CodeGenerator::generateInfix(
   const OperatorRecord &theOperator,
   const ExpressionRecord &theRightOperand) noexcept
 {
-  std::cout << "Call generateInfix" << std::endl;
+  trace("generateInfix");
+
+  int64_t left;
+  int64_t right;
+  if (theLeftOperand.getLiteralValue(left) &&
+      theRightOperand.getLiteralValue(right))
+  {
+    int64_t result;
+    if (! theOperator.evaluate(left, right, result))
+    {
+      myStatistics.add("constant expressions folded");
+      return ExpressionRecord(ExpressionRecord::Type::Literal,
+                              std::to_string(result));
+    }
+
+    // Leave it to run time; folding must not change the program's behavior.
+    // (Its operands may be folded already, so they're not what was
+    // written; the line is, as for an error at run time.)
+    if (Instruction::OpCode::Pow == theOperator.getInstruction() &&
+        0 == left && right < 0)
+    {
+      myStatistics.add(
+        "constant expressions not folded (zero to a negative power)");
+      myEWTracker.reportWarning(
+        "zero to a negative power in constant expression on line " +
+        std::to_string(myLine));
+    }
+    else
+    {
+      myStatistics.add("constant expressions not folded (overflow)");
+      myEWTracker.reportWarning(
+        "integer overflow in constant expression on line " +
+        std::to_string(myLine));
+    }
+  }
+
+  auto node = myExpressions.getNode(theOperator.getInstruction(),
+                                    toNode(theLeftOperand),
+                                    toNode(theRightOperand));
+  return ExpressionRecord(ExpressionRecord::Type::Node, "", node);
+}
+
+//**************************************************
+// CodeGenerator::getPassManager
+//**************************************************
+const PassManager& CodeGenerator::getPassManager() const noexcept
+{
+  return myPasses;
+}
 
-  std::string tempName(getTemp());
-  generate(theOperator.getInstruction(),
-           theLeftOperand.getValue(), theRightOperand.getValue(), tempName);
-  return ExpressionRecord(ExpressionRecord::Type::Temporary, tempName);
+//**************************************************
+// CodeGenerator::getStatistics
+//**************************************************
+const Statistics& CodeGenerator::getStatistics() const noexcept
+{
+  return myStatistics;
 }
 
 //**************************************************
 // CodeGenerator::getTemp
 //**************************************************
-std::string CodeGenerator::getTemp() noexcept
+ExpressionRecord CodeGenerator::getTemp() noexcept
+{
+  trace("getTemp");
+
+  auto temp = myProgram.newTemporary();
+  return ExpressionRecord(ExpressionRecord::Type::Temporary,
+                          myProgram.getName(temp), temp.getIndex());
+}
+
+//**************************************************
+// CodeGenerator::materialize
+//**************************************************
+Operand CodeGenerator::materialize(uint32_t theNode) noexcept
 {
-  std::cout << "Call getTemp" << std::endl;
+  // Nodes still to be computed; the flag is set once the operands have
+  // been queued (i.e., the node can be computed when next seen).
+  std::vector<std::pair<uint32_t, bool>> pending{{theNode, false}};
+  while (! pending.empty())
+  {
+    auto node = pending.back().first;
+    auto operandsDone = pending.back().second;
+    pending.pop_back();
+    if (myExpressions.isLeaf(node) ||
+        Operand::Kind::None != myExpressions.getResult(node).getKind())
+    {
+      continue;
+    }
 
-  ++myMaxTemp;
-  std::string tempVariable{"Temp&"};
-  tempVariable += std::to_string(myMaxTemp);
-  checkId(tempVariable);
-  return tempVariable;
+    if (! operandsDone)
+    {
+      pending.emplace_back(node, true);
+      pending.emplace_back(myExpressions.getRight(node), false);
+      pending.emplace_back(myExpressions.getLeft(node), false);
+      continue;
+    }
+
+    auto temp = toOperand(getTemp());
+    generate(Instruction(myExpressions.getOpCode(node),
+                         myExpressions.getResult(myExpressions.getLeft(node)),
+                         myExpressions.getResult(myExpressions.getRight(node)),
+                         temp));
+    myExpressions.setResult(node, temp);
+  }
+  return myExpressions.getResult(theNode);
 }
 
 //**************************************************
-// CodeGenerator::lookUp
+// CodeGenerator::optimize
 //**************************************************
-bool CodeGenerator::lookUp(const std::string &theIdentifier) const noexcept
+void CodeGenerator::optimize()
 {
-  auto location =
-    std::find(mySymbolTable.begin(), mySymbolTable.end(), theIdentifier);
-  bool found = (location != mySymbolTable.end());
-  return found;
+  // Each pass with the lowest optimization level it runs at. Level 1 is
+  // the cheap passes, each a scan or two over the program; level 2 adds
+  // those which rebuild expressions. Passes which drop computations never
+  // run with --keep-all (but are still known to --disable).
+  auto keepAll = myOptions.isKeepAll();
+  std::vector<std::pair<int, std::unique_ptr<Pass>>> passes;
+  passes.emplace_back(keepAll ? INT_MAX : 1, std::unique_ptr<Pass>(
+                        new CompileTimeEvaluation(myOptions.isChecked())));
+  passes.emplace_back(2, std::unique_ptr<Pass>(
+                        new Reassociation(myOptions.isOrderPreserved())));
+  passes.emplace_back(1, std::unique_ptr<Pass>(new StrengthReduction()));
+  passes.emplace_back(1, std::unique_ptr<Pass>(new ValueNumbering()));
+  passes.emplace_back(1, std::unique_ptr<Pass>(new CopyPropagation()));
+  passes.emplace_back(keepAll ? INT_MAX : 1,
+                      std::unique_ptr<Pass>(new DeadCodeElimination()));
+  passes.emplace_back(1, std::unique_ptr<Pass>(new Peephole()));
+  // Must be last, temporaries are no longer single assignment afterwards.
+  passes.emplace_back(1, std::unique_ptr<Pass>(new TemporaryAllocation()));
+
+  for (auto &disabled : myOptions.getDisabledPasses())
+  {
+    bool known = false;
+    for (auto &pass : passes)
+    {
+      known = known || (disabled == pass.second->getName());
+    }
+    if (! known)
+    {
+      myEWTracker.reportWarning("unknown optimization pass '" + disabled +
+                                "'");
+    }
+  }
+
+  for (auto &pass : passes)
+  {
+    if (pass.first <= myOptions.getOptimizationLevel() &&
+        myOptions.isPassEnabled(pass.second->getName()))
+    {
+      myPasses.add(std::move(pass.second));
+    }
+  }
+  myPasses.run(myProgram, myStatistics);
 }
 
 //**************************************************
@@ -175,23 +426,33 @@ void CodeGenerator::printCode(const std::string &theCode) const noexcept
 //**************************************************
 // CodeGenerator::processId
 //**************************************************
-ExpressionRecord CodeGenerator::processId(const std::string &theToken) noexcept
+ExpressionRecord CodeGenerator::processId(const Token &theToken) noexcept
 {
-  std::cout << "Call processId" << std::endl;
+  trace("processId");
 
-  checkId(theToken);
-  return ExpressionRecord(ExpressionRecord::Type::Id, theToken);
+  auto index = checkId(theToken.getLiteral(), theToken.getHash());
+  return ExpressionRecord(ExpressionRecord::Type::Id, theToken.getLiteral(),
+                          index);
 }
 
 //**************************************************
 // CodeGenerator::processLiteral
 //**************************************************
-ExpressionRecord CodeGenerator::processLiteral(const std::string &theLiteral)
+ExpressionRecord CodeGenerator::processLiteral(const Token &theLiteral)
   noexcept
 {
-  std::cout << "Call processLiteral" << std::endl;
+  trace("processLiteral");
 
-  return ExpressionRecord(ExpressionRecord::Type::Literal, theLiteral);
+  ExpressionRecord literal(ExpressionRecord::Type::Literal,
+                           theLiteral.getLiteral());
+  int64_t value;
+  if (! literal.getLiteralValue(value))
+  {
+    Token errorToken(theLiteral);
+    myEWTracker.reportError(errorToken, "Integer literal '" +
+                            theLiteral.getLiteral() + "' is out of range.");
+  }
+  return literal;
 }
 
 //**************************************************
@@ -200,12 +461,16 @@ ExpressionRecord CodeGenerator::processLiteral(const std::string &theLiteral)
 OperatorRecord CodeGenerator::processOperator(const std::string &theOperator)
   noexcept
 {
-  std::cout << "Call processOperator" << std::endl;
+  trace("processOperator");
 
   if ("+" == theOperator)
   {
     return OperatorRecord(Token::Type::PlusOp);
   }
+  if ("**" == theOperator)
+  {
+    return OperatorRecord(Token::Type::ExponentOp);
+  }
   return OperatorRecord(Token::Type::MinusOp);
 }
 
@@ -214,9 +479,19 @@ OperatorRecord CodeGenerator::processOperator(const std::string &theOperator)
 //**************************************************
 void CodeGenerator::readId(const ExpressionRecord &theIdentifier) noexcept
 {
-  std::cout << "Call readId" << std::endl;
+  trace("readId");
 
-  generate("Read", theIdentifier.getValue(), "Integer");
+  auto symbol = toOperand(theIdentifier);
+  myExpressions.assign(symbol);
+  generate(Instruction(Instruction::OpCode::Read, symbol));
+}
+
+//**************************************************
+// CodeGenerator::setLine
+//**************************************************
+void CodeGenerator::setLine(uint32_t theLine) noexcept
+{
+  myLine = theLine;
 }
 
 //**************************************************
@@ -224,9 +499,59 @@ void CodeGenerator::readId(const ExpressionRecord &theIdentifier) noexcept
 //**************************************************
 void CodeGenerator::start() noexcept
 {
-  std::cout << "Call start" << std::endl;
-  // myMaxTemp is initialized in the .h file
-  // No symbol table maximum as a vector is used.
+  trace("start");
+  // Temporary numbering starts at 1 (see Program).
+  // No symbol table maximum as the symbol table grows as needed.
+}
+
+//**************************************************
+// CodeGenerator::toNode
+//**************************************************
+uint32_t CodeGenerator::toNode(const ExpressionRecord &theExpression) noexcept
+{
+  if (ExpressionRecord::Type::Node == theExpression.getType())
+  {
+    return theExpression.getIndex();
+  }
+  return myExpressions.getLeaf(toOperand(theExpression));
+}
+
+//**************************************************
+// CodeGenerator::toOperand
+//**************************************************
+Operand CodeGenerator::toOperand(const ExpressionRecord &theExpression)
+  noexcept
+{
+  switch (theExpression.getType())
+  {
+    case ExpressionRecord::Type::Node:
+      return materialize(theExpression.getIndex());
+
+    case ExpressionRecord::Type::Id:
+      return Operand(Operand::Kind::Symbol, theExpression.getIndex());
+
+    case ExpressionRecord::Type::Temporary:
+      return Operand(Operand::Kind::Temporary, theExpression.getIndex());
+
+    default:
+    {
+      // Out of range literals have already been reported as errors.
+      int64_t value = 0;
+      theExpression.getLiteralValue(value);
+      return Operand(Operand::Kind::Literal, value);
+    }
+  }
+}
+
+//**************************************************
+// CodeGenerator::trace
+//**************************************************
+void CodeGenerator::trace(const char *theFunction) const noexcept
+{
+  if (myOptions.isTraceEnabled())
+  {
+    std::cout << "Call " << theFunction << std::endl;
+  }
 }
 
 //**************************************************
@@ -235,7 +560,31 @@ void CodeGenerator::start() noexcept
 void CodeGenerator::writeExpression(const ExpressionRecord &theExpression)
   noexcept
 {
-  std::cout << "Call writeExpression" << std::endl;
+  trace("writeExpression");
+
+  generate(Instruction(Instruction::OpCode::Write, toOperand(theExpression)));
+}
+
+//**************************************************
+// CodeGenerator::writeObject
+//**************************************************
+void CodeGenerator::writeObject()
+{
+  Bytecode bytecode(myProgram, myOptions.isChecked());
+  if (myOptions.isSuperinstructionsEnabled())
+  {
+    bytecode.fuse();
+  }
+
+  std::vector<uint8_t> nativeCode;
+  std::vector<uint32_t> traps;
+#ifdef __x86_64__
+  JitBackend jit;
+  jit.compile(myProgram, myOptions.isChecked());
+  nativeCode = jit.getCode();
+  traps = jit.getTraps();
+#endif
 
-  generate("Write", theExpression.getValue(), "Integer");
+  ObjectFile::write(myOptions.getObjectFile(), myProgram, bytecode,
+                    nativeCode, traps, myOptions.getInputFile());
 }
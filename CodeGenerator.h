@@ -10,14 +10,23 @@
 
 #include <cstdint>
 #include <string>
-#include <vector>
 
+#include "ExpressionDAG.h"
+#include "PassManager.h"
+#include "Program.h"
+#include "Statistics.h"
+
+class CompilerOptions;
 class ErrorWarningTracker;
 class ExpressionRecord;
 class OperatorRecord;
+class OutputSink;
+class Token;
 
 /**
- * 
+ * Semantic routines of the Micro compiler. Code is built up as intermediate
+ * code (see Program) while parsing, then optimized and written to the output
+ * sink when the program is finished.
  */
 class CodeGenerator
 {
@@ -44,15 +53,21 @@ class CodeGenerator
   /**
    * Constructor.
    *
+   * @param theSink
+   *          destination of generated code
    * @param theEWTracker
    *          error/warning tracker
+   * @param theOptions
+   *          command line options
    */
-  CodeGenerator(ErrorWarningTracker &theEWTracker);
+  CodeGenerator(OutputSink &theSink,
+                ErrorWarningTracker &theEWTracker,
+                const CompilerOptions &theOptions);
 
   /**
    * Destructor
    */
-  ~CodeGenerator();
+  ~CodeGenerator() = default;
 
   /**
    * Copy assignment operator
@@ -65,7 +80,8 @@ class CodeGenerator
   CodeGenerator& operator=(const CodeGenerator &&) = delete;
 
   /**
-   * Generator code for a variable assignment.
+   * Generator code for a variable assignment. When the source was just
+   * computed the computation is redirected into the destination instead.
    *
    * @param theSource
    *          source expression
@@ -81,16 +97,33 @@ class CodeGenerator
    *
    * @param theIdentifier
    *          identifer to chec on
+   * @param theHash
+   *          hash of the identifier (see Token::hash)
+   * @return symbol table index of the identifier
    */
-  void checkId(const std::string &theIdentifier) noexcept;
+  uint32_t checkId(const std::string &theIdentifier, uint64_t theHash)
+    noexcept;
 
   /**
-   * Generates code to terminate a program
+   * Generates code to terminate a program, optimizes the program and writes
+   * it to the output sink.
    */
   void finish();
 
   /**
-   * Generates code for an infix calculation (i.e., A + B)
+   * Runs the finished program in process (see CompilerOptions::Execution),
+   * reading stdin and writing stdout.
+   *
+   * @throws std::runtime_error
+   *           if the program can't be run
+   */
+  void execute();
+
+  /**
+   * Processes an infix calculation (i.e., A + B). If both operands are
+   * literals the calculation is done here (unless it overflows). Otherwise
+   * the calculation is added to the expression DAG; its code is generated
+   * when the expression is used, unless it has already been computed.
    *
    * @param theLeftOperand
    *          operand on left side of operator
@@ -106,31 +139,46 @@ class CodeGenerator
     noexcept;
 
   /**
-   * Returns the name of a new temporary variable and generates
-   * code to allocate space for the temporary.
+   * Returns statistics collected during code generation.
    *
-   * @return name of temporary variable
+   * @return code generation statistics
    */
-  std::string getTemp() noexcept;
+  const Statistics& getStatistics() const noexcept;
+
+  /**
+   * Returns the optimization pipeline (and what each pass cost).
+   *
+   * @return pass manager
+   */
+  const PassManager& getPassManager() const noexcept;
+
+  /**
+   * Returns a new temporary variable. Space for temporaries is allocated
+   * when the code is written.
+   *
+   * @return temporary variable
+   */
+  ExpressionRecord getTemp() noexcept;
 
   /**
    * Declare Id, enter it into the semantic table, and return a corresponding
    * semantic record
    *
    * @param theToken
-   *          token from source
+   *          identifier token from source
    * @return record for token
    */
-  ExpressionRecord processId(const std::string &theToken) noexcept;
+  ExpressionRecord processId(const Token &theToken) noexcept;
 
   /**
-   * Returns a semantic record for the given literal
+   * Returns a semantic record for the given literal. An error is reported if
+   * the literal doesn't fit in a 64-bit signed integer.
    *
    * @param theLiteral
-   *          literal from source
+   *          literal token from source
    * @return record for literal
    */
-  ExpressionRecord processLiteral(const std::string &theLiteral) noexcept;
+  ExpressionRecord processLiteral(const Token &theLiteral) noexcept;
 
   /**
    * Returns an operator record for the given operator.
@@ -149,6 +197,15 @@ class CodeGenerator
    */
   void readId(const ExpressionRecord &theIdentifier) noexcept;
 
+  /**
+   * Sets the source line of the statement being parsed, recorded in the
+   * code generated for it.
+   *
+   * @param theLine
+   *          line
+   */
+  void setLine(uint32_t theLine) noexcept;
+
   /**
    * Initializes symbol table.
    */
@@ -172,46 +229,20 @@ class CodeGenerator
    *
    * @param theIdentifier
    *          identifier to add
+   * @param theHash
+   *          hash of the identifier (see Token::hash)
+   * @return symbol table index of the identifier
    */
-  void enter(const std::string theIdentifier) noexcept;
-
-  /**
-   * Writes a no-operand instruction.
-   *
-   * @param theInstruction
-   *          instruction
-   */
-  void generate(const std::string &theInstruction) noexcept;
+  uint32_t enter(const std::string &theIdentifier, uint64_t theHash) noexcept;
 
   /**
-   * Writes a 2 operand instruction.
-   *
-   * @param theInstruction
-   *          instruction
-   * @param theFirst
-   *          first argument to instruction
-   * @param theSecond
-   *          second argument to instruction
-   */
-  void generate(const std::string &theInstruction,
-                const std::string &theFirst,
-                const std::string &theSecond) noexcept;
-  /**
-   * Writes a 3 operand instruction.
+   * Adds an instruction to the program (and to the trace if tracing is
+   * enabled).
    *
    * @param theInstruction
    *          instruction
-   * @param theFirst
-   *          first argument to instruction
-   * @param theSecond
-   *          second argument to instruction
-   * @param theThird
-   *          third argument to instruction
    */
-  void generate(const std::string &theInstruction,
-                const std::string &theFirst,
-                const std::string &theSecond,
-                const std::string &theThird) noexcept;
+  void generate(const Instruction &theInstruction) noexcept;
 
   /**
    * Checks if the given identifier is in the symbol table.
@@ -219,10 +250,29 @@ class CodeGenerator
    *
    * @param theIdentifier
    *          identifier to look for
+   * @param theHash
+   *          hash of the identifier (see Token::hash)
    * @return true if the identifier is in the symbol table,
    *         otherwise false
    */
-  bool lookUp(const std::string &theIdentifier) const noexcept;
+  bool lookUp(const std::string &theIdentifier, uint64_t theHash)
+    const noexcept;
+
+  /**
+   * Generates code for an expression node and any of its operands not yet
+   * computed (a post-order walk of the DAG).
+   *
+   * @param theNode
+   *          expression node number
+   * @return operand holding the value of the expression
+   */
+  Operand materialize(uint32_t theNode) noexcept;
+
+  /**
+   * Runs the optimization passes enabled at the optimization level over the
+   * program.
+   */
+  void optimize();
 
   /**
    * Prints a line of code to stdout.
@@ -232,23 +282,68 @@ class CodeGenerator
    */
   void printCode(const std::string &theCode) const noexcept;
 
+  /**
+   * Returns the expression DAG node of a semantic record.
+   *
+   * @param theExpression
+   *          expression record
+   * @return expression node number
+   */
+  uint32_t toNode(const ExpressionRecord &theExpression) noexcept;
+
+  /**
+   * Converts a semantic record into an instruction operand, generating the
+   * code for it if it is an expression not yet computed.
+   *
+   * @param theExpression
+   *          expression record
+   * @return operand
+   */
+  Operand toOperand(const ExpressionRecord &theExpression) noexcept;
+
+  /**
+   * Prints the name of a called semantic routine, if tracing is enabled.
+   *
+   * @param theFunction
+   *          name of the function
+   */
+  void trace(const char *theFunction) const noexcept;
+
+  /**
+   * Writes the program to the object file given on the command line, with
+   * native code when the JIT can generate it.
+   */
+  void writeObject();
+
   // ************************************************************
   // Private
   // ************************************************************
   private:
 
-  /** All code generated. */
-  std::string myGeneratedCode;
+  /** Program being generated (also holds the symbol table). */
+  Program myProgram;
+
+  /** Every expression parsed. */
+  ExpressionDAG myExpressions;
 
-  /** Temporary variable id */
-  uint32_t myMaxTemp = 0;
+  /** Code generation statistics. */
+  Statistics myStatistics;
 
-  /** Known symbols */
-  std::vector<std::string> mySymbolTable;
+  /** Optimization pipeline. */
+  PassManager myPasses;
 
   /** Tracker of errors and warnings during scanning and parsing. */
   ErrorWarningTracker &myEWTracker;
 
+  /** Source line of the statement being parsed. */
+  uint32_t myLine = 0;
+
+  /** Command line options. */
+  const CompilerOptions &myOptions;
+
+  /** Destination of generated code. */
+  OutputSink &mySink;
+
 };
 
 #endif
@@ -0,0 +1,119 @@
+/**
+ * @file CompileTimeEvaluation.cpp
+ * @brief Implementation of CompileTimeEvaluation class
+ *
+ * @author Michael Albers
+ */
+
+#include <vector>
+
+#include "CompileTimeEvaluation.h"
+#include "OperatorRecord.h"
+#include "Program.h"
+#include "Statistics.h"
+
+//**************************************************
+// CompileTimeEvaluation::CompileTimeEvaluation
+//**************************************************
+CompileTimeEvaluation::CompileTimeEvaluation(bool theChecked) :
+  myChecked(theChecked)
+{
+}
+
+//**************************************************
+// CompileTimeEvaluation::getName
+//**************************************************
+const char* CompileTimeEvaluation::getName() const noexcept
+{
+  return "evaluation";
+}
+
+//**************************************************
+// CompileTimeEvaluation::run
+//**************************************************
+void CompileTimeEvaluation::run(Program &theProgram,
+                                AnalysisManager &theAnalyses,
+                                Statistics &theStatistics)
+{
+  setChanged(false);
+  auto &instructions = theProgram.getInstructions();
+  for (auto &instruction : instructions)
+  {
+    if (Instruction::OpCode::Read == instruction.getOpCode())
+    {
+      return;
+    }
+  }
+
+  std::vector<int64_t> values(theProgram.getSlotCount(), 0);
+  auto valueOf = [&](const Operand &theOperand)
+  {
+    return theOperand.isVariable() ?
+      values[theProgram.getSlot(theOperand)] : theOperand.getValue();
+  };
+
+  std::vector<Instruction> code;
+  for (auto &instruction : instructions)
+  {
+    if (Instruction::OpCode::Halt == instruction.getOpCode())
+    {
+      break;
+    }
+
+    int64_t result = 0;
+    bool overflow = false;
+    switch (instruction.getOpCode())
+    {
+      case Instruction::OpCode::Declare:
+      case Instruction::OpCode::Read:
+      case Instruction::OpCode::Halt:
+        continue;
+
+      case Instruction::OpCode::Write:
+        code.emplace_back(Instruction::OpCode::Write,
+                          Operand(Operand::Kind::Literal,
+                                  valueOf(instruction.getOperand(0))));
+        code.back().setLine(instruction.getLine());
+        continue;
+
+      case Instruction::OpCode::Store:
+        result = valueOf(instruction.getOperand(0));
+        break;
+
+      case Instruction::OpCode::Add:
+        overflow = OperatorRecord(Token::Type::PlusOp).evaluate(
+          valueOf(instruction.getOperand(0)),
+          valueOf(instruction.getOperand(1)), result);
+        break;
+
+      case Instruction::OpCode::Sub:
+        overflow = OperatorRecord(Token::Type::MinusOp).evaluate(
+          valueOf(instruction.getOperand(0)),
+          valueOf(instruction.getOperand(1)), result);
+        break;
+
+      case Instruction::OpCode::Mul:
+        overflow = __builtin_mul_overflow(valueOf(instruction.getOperand(0)),
+                                          valueOf(instruction.getOperand(1)),
+                                          &result);
+        break;
+
+      case Instruction::OpCode::Pow:
+        overflow = OperatorRecord::power(valueOf(instruction.getOperand(0)),
+                                         valueOf(instruction.getOperand(1)),
+                                         result);
+        break;
+    }
+    if (overflow && myChecked)
+    {
+      return;
+    }
+    values[theProgram.getSlot(instruction.getDestination())] = result;
+  }
+
+  code.emplace_back(Instruction::OpCode::Halt);
+  theStatistics.add("instructions evaluated at compile time",
+                    instructions.size());
+  instructions.swap(code);
+  setChanged(true);
+}
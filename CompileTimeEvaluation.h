@@ -0,0 +1,67 @@
+#ifndef COMPILETIMEEVALUATION_H
+#define COMPILETIMEEVALUATION_H
+
+/**
+ * @file CompileTimeEvaluation.h
+ * @brief Defines the pass which runs input-free programs at compile time.
+ *
+ * @author Michael Albers
+ */
+
+#include "Pass.h"
+
+/**
+ * Whole program evaluation. A program with no Read always writes the same
+ * values, so it is run here, with the same arithmetic as at run time
+ * (wrapping on overflow, see OperatorRecord::evaluate), and replaced by a
+ * Write of each value it wrote, then Halt. Each Write keeps its source
+ * line.
+ *
+ * Checked code (--checked) which overflows would stop at run time, with an
+ * error for the line; such a program is left as it is so it still does.
+ */
+class CompileTimeEvaluation : public Pass
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  CompileTimeEvaluation() = delete;
+
+  /**
+   * Constructor
+   *
+   * @param theChecked
+   *          arithmetic is checked (stops on signed overflow)?
+   */
+  explicit CompileTimeEvaluation(bool theChecked);
+
+  /**
+   * Destructor
+   */
+  virtual ~CompileTimeEvaluation() = default;
+
+  virtual const char* getName() const noexcept override;
+
+  virtual void run(Program &theProgram, AnalysisManager &theAnalyses,
+                   Statistics &theStatistics) override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Arithmetic is checked? */
+  bool myChecked;
+};
+
+#endif
@@ -0,0 +1,388 @@
+/**
+ * @file CompilerOptions.cpp
+ * @brief Implementation of CompilerOptions class
+ *
+ * @author Michael Albers
+ */
+
+#include <stdexcept>
+
+#include <getopt.h>
+
+#include "CompilerOptions.h"
+
+//**************************************************
+// CompilerOptions::CompilerOptions
+//**************************************************
+CompilerOptions::CompilerOptions(int theArgc, char **theArgv)
+{
+  static const struct option longOptions[] = {
+    {"check-only", no_argument, nullptr, 'n'},
+    {"disable", required_argument, nullptr, 'd'},
+    {"execute", required_argument, nullptr, 'x'},
+    {"optimize", required_argument, nullptr, 'O'},
+    {"output", required_argument, nullptr, 'o'},
+    // Long only.
+    {"binary", no_argument, nullptr, 'B'},
+    {"checked", no_argument, nullptr, 'C'},
+    {"emit-object", required_argument, nullptr, 'E'},
+    {"instrument", optional_argument, nullptr, 'I'},
+    {"keep-all", no_argument, nullptr, 'K'},
+    {"no-superinstructions", no_argument, nullptr, 'F'},
+    {"pass-stats", no_argument, nullptr, 'S'},
+    {"preserve-order", no_argument, nullptr, 'p'},
+    {"quiet", no_argument, nullptr, 'q'},
+    {"stats", no_argument, nullptr, 's'},
+    {"target", required_argument, nullptr, 't'},
+    {nullptr, 0, nullptr, 0}};
+
+  // Allow for multiple instances (getopt keeps global state).
+  optind = 1;
+  opterr = 0;
+
+  int option;
+  while ((option = getopt_long(theArgc, theArgv, "d:no:O:pqst:x:", longOptions,
+                               nullptr)) != -1)
+  {
+    switch (option)
+    {
+      case 'B':
+        myBatchBinary = true;
+        break;
+
+      case 'C':
+        myChecked = true;
+        break;
+
+      case 'd':
+        myDisabledPasses.insert(optarg);
+        break;
+
+      case 'E':
+        myObjectFile = optarg;
+        break;
+
+      case 'F':
+        mySuperinstructions = false;
+        break;
+
+      case 'I':
+        if (nullptr == optarg)
+        {
+          myInstrument = Instrument::Counts;
+        }
+        else if (std::string("cycles") == optarg)
+        {
+          myInstrument = Instrument::Cycles;
+        }
+        else
+        {
+          throw std::runtime_error(
+            "Invalid instrumentation '" + std::string(optarg) + "'.\n" +
+            usage(theArgv[0]));
+        }
+        break;
+
+      case 'K':
+        myKeepAll = true;
+        break;
+
+      case 'n':
+        myCheckOnly = true;
+        break;
+
+      case 'o':
+        myOutputFile = optarg;
+        break;
+
+      case 'O':
+        if (std::string("0") == optarg || std::string("1") == optarg ||
+            std::string("2") == optarg)
+        {
+          myOptimizationLevel = optarg[0] - '0';
+        }
+        else
+        {
+          throw std::runtime_error(
+            "Invalid optimization level '" + std::string(optarg) + "'.\n" +
+            usage(theArgv[0]));
+        }
+        break;
+
+      case 'p':
+        myPreserveOrder = true;
+        break;
+
+      case 'q':
+        myTrace = false;
+        break;
+
+      case 's':
+        myStatistics = true;
+        break;
+
+      case 'S':
+        myPassStatistics = true;
+        break;
+
+      case 't':
+        if (std::string("text") == optarg)
+        {
+          myTarget = Target::Text;
+        }
+        else if (std::string("x86-64") == optarg)
+        {
+          myTarget = Target::X86_64;
+        }
+        else if (std::string("c") == optarg)
+        {
+          myTarget = Target::C;
+        }
+        else
+        {
+          throw std::runtime_error(
+            "Invalid target '" + std::string(optarg) + "'.\n" +
+            usage(theArgv[0]));
+        }
+        break;
+
+      case 'x':
+        if (std::string("jit") == optarg)
+        {
+          myExecution = Execution::Jit;
+        }
+        else if (std::string("vm") == optarg)
+        {
+          myExecution = Execution::Vm;
+        }
+        else if (std::string("batch") == optarg)
+        {
+          myExecution = Execution::Batch;
+        }
+        else
+        {
+          throw std::runtime_error(
+            "Invalid execution mode '" + std::string(optarg) + "'.\n" +
+            usage(theArgv[0]));
+        }
+        break;
+
+      default:
+        throw std::runtime_error(
+          "Invalid option '" + std::string(theArgv[optind - 1]) + "'.\n" +
+          usage(theArgv[0]));
+    }
+  }
+
+  if (myChecked && Execution::Batch == myExecution)
+  {
+    throw std::runtime_error(
+      "Checked arithmetic (--checked) isn't supported with -x batch.");
+  }
+
+  if (Instrument::None != myInstrument && Target::X86_64 != myTarget)
+  {
+    throw std::runtime_error(
+      "Instrumentation (--instrument) is only generated for -t x86-64.");
+  }
+
+  if (optind >= theArgc)
+  {
+    throw std::runtime_error("No input file provided.");
+  }
+  myInputFile = theArgv[optind];
+}
+
+//**************************************************
+// CompilerOptions::getDisabledPasses
+//**************************************************
+const std::set<std::string>& CompilerOptions::getDisabledPasses()
+  const noexcept
+{
+  return myDisabledPasses;
+}
+
+//**************************************************
+// CompilerOptions::getExecution
+//**************************************************
+CompilerOptions::Execution CompilerOptions::getExecution() const noexcept
+{
+  return myExecution;
+}
+
+//**************************************************
+// CompilerOptions::getInputFile
+//**************************************************
+const std::string& CompilerOptions::getInputFile() const noexcept
+{
+  return myInputFile;
+}
+
+//**************************************************
+// CompilerOptions::getInstrument
+//**************************************************
+CompilerOptions::Instrument CompilerOptions::getInstrument() const noexcept
+{
+  return myInstrument;
+}
+
+//**************************************************
+// CompilerOptions::getObjectFile
+//**************************************************
+const std::string& CompilerOptions::getObjectFile() const noexcept
+{
+  return myObjectFile;
+}
+
+//**************************************************
+// CompilerOptions::getOptimizationLevel
+//**************************************************
+int CompilerOptions::getOptimizationLevel() const noexcept
+{
+  return myOptimizationLevel;
+}
+
+//**************************************************
+// CompilerOptions::getOutputFile
+//**************************************************
+const std::string& CompilerOptions::getOutputFile() const noexcept
+{
+  return myOutputFile;
+}
+
+//**************************************************
+// CompilerOptions::getTarget
+//**************************************************
+CompilerOptions::Target CompilerOptions::getTarget() const noexcept
+{
+  return myTarget;
+}
+
+//**************************************************
+// CompilerOptions::isBatchBinary
+//**************************************************
+bool CompilerOptions::isBatchBinary() const noexcept
+{
+  return myBatchBinary;
+}
+
+//**************************************************
+// CompilerOptions::isChecked
+//**************************************************
+bool CompilerOptions::isChecked() const noexcept
+{
+  return myChecked;
+}
+
+//**************************************************
+// CompilerOptions::isCheckOnly
+//**************************************************
+bool CompilerOptions::isCheckOnly() const noexcept
+{
+  return myCheckOnly;
+}
+
+//**************************************************
+// CompilerOptions::isKeepAll
+//**************************************************
+bool CompilerOptions::isKeepAll() const noexcept
+{
+  return myKeepAll;
+}
+
+//**************************************************
+// CompilerOptions::isPassEnabled
+//**************************************************
+bool CompilerOptions::isPassEnabled(const std::string &thePass) const noexcept
+{
+  return myDisabledPasses.find(thePass) == myDisabledPasses.end();
+}
+
+//**************************************************
+// CompilerOptions::isOrderPreserved
+//**************************************************
+bool CompilerOptions::isOrderPreserved() const noexcept
+{
+  // Reassociation could hide (or introduce) an overflow.
+  return myPreserveOrder || myChecked;
+}
+
+//**************************************************
+// CompilerOptions::isPassStatisticsEnabled
+//**************************************************
+bool CompilerOptions::isPassStatisticsEnabled() const noexcept
+{
+  return myPassStatistics;
+}
+
+//**************************************************
+// CompilerOptions::isStatisticsEnabled
+//**************************************************
+bool CompilerOptions::isStatisticsEnabled() const noexcept
+{
+  return myStatistics;
+}
+
+//**************************************************
+// CompilerOptions::isSuperinstructionsEnabled
+//**************************************************
+bool CompilerOptions::isSuperinstructionsEnabled() const noexcept
+{
+  return mySuperinstructions;
+}
+
+//**************************************************
+// CompilerOptions::isTraceEnabled
+//**************************************************
+bool CompilerOptions::isTraceEnabled() const noexcept
+{
+  return myTrace;
+}
+
+//**************************************************
+// CompilerOptions::usage
+//**************************************************
+std::string CompilerOptions::usage(const std::string &theProgram)
+{
+  return "Usage: " + theProgram + " [options] file\n"
+    "  -d, --disable PASS   don't run optimization pass PASS\n"
+    "                       (evaluation, reassociation,\n"
+    "                       strength-reduction, value-numbering,\n"
+    "                       copy-propagation, dead-code, peephole,\n"
+    "                       temporary-allocation)\n"
+    "  -n, --check-only     check the source, discard generated code\n"
+    "  -o, --output FILE    write generated code to FILE (default stdout)\n"
+    "  -O, --optimize LEVEL optimization level: 0 none, 1 cheap local\n"
+    "                       passes, 2 all passes (default)\n"
+    "  -p, --preserve-order keep the evaluation order of expressions as\n"
+    "                       written (no reassociation)\n"
+    "  -q, --quiet          don't trace parsing and code generation\n"
+    "  -s, --stats          print compilation statistics to stderr\n"
+    "  -t, --target TARGET  form of the generated code: text (Micro\n"
+    "                       pseudo-assembly, default), x86-64 (GNU as,\n"
+    "                       link with libMicroRuntime.a) or c (a C\n"
+    "                       program)\n"
+    "  -x, --execute MODE   run the program once compiled, on stdin and\n"
+    "                       stdout: jit (native code in memory), vm\n"
+    "                       (bytecode interpreter) or batch (once per\n"
+    "                       input record, see --binary); code is only\n"
+    "                       written with -o\n"
+    "      --binary         batch records are raw int64_t fields (default\n"
+    "                       lines of comma separated integers)\n"
+    "      --checked        stop with the source line on integer overflow\n"
+    "                       (implies --preserve-order; not with -x batch)\n"
+    "      --emit-object FILE\n"
+    "                       also write the compiled program to FILE, which\n"
+    "                       runs (-x vm or jit) in place of the source file\n"
+    "      --instrument[=cycles]\n"
+    "                       count (and time) the runs of each source line\n"
+    "                       in -t x86-64 code, which writes them to\n"
+    "                       $MICRO_PROFILE (default micro.prof) on Halt\n"
+    "      --keep-all       keep computations which can't affect the output\n"
+    "                       (no dead code elimination or compile time\n"
+    "                       evaluation, for debugging)\n"
+    "      --no-superinstructions\n"
+    "                       run one bytecode operation per dispatch (-x vm)\n"
+    "      --pass-stats     print the time taken and effect of each\n"
+    "                       optimization pass to stderr";
+}
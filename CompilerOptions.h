@@ -0,0 +1,303 @@
+#ifndef COMPILEROPTIONS_H
+#define COMPILEROPTIONS_H
+
+/**
+ * @file CompilerOptions.h
+ * @brief Defines the class holding command line options.
+ *
+ * @author Michael Albers
+ */
+
+#include <set>
+#include <string>
+
+/**
+ * Parses and holds the command line options of the compiler.
+ */
+class CompilerOptions
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** How to run the program once compiled. */
+  enum class Execution
+  {
+    None,
+    Jit,
+    Vm,
+    Batch
+  };
+
+  /** Profiling instrumentation of generated code. */
+  enum class Instrument
+  {
+    None,
+    /** Count the runs of each source line. */
+    Counts,
+    /** Also time each source line with the time stamp counter. */
+    Cycles
+  };
+
+  /** Form of the generated code. */
+  enum class Target
+  {
+    Text,
+    X86_64,
+    C
+  };
+
+  /**
+   * Default constructor.
+   */
+  CompilerOptions() = delete;
+
+  /**
+   * Copy constructor
+   */
+  CompilerOptions(const CompilerOptions &) = default;
+
+  /**
+   * Move constructor
+   */
+  CompilerOptions(CompilerOptions &&) = default;
+
+  /**
+   * Constructor. Parses the command line.
+   *
+   * @param theArgc
+   *          number of arguments (from main)
+   * @param theArgv
+   *          arguments (from main)
+   * @throws std::runtime_error
+   *           on invalid or missing arguments
+   */
+  CompilerOptions(int theArgc, char **theArgv);
+
+  /**
+   * Destructor
+   */
+  ~CompilerOptions() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  CompilerOptions& operator=(const CompilerOptions &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  CompilerOptions& operator=(CompilerOptions &&) = default;
+
+  /**
+   * Returns the source file to compile.
+   *
+   * @return source file
+   */
+  const std::string& getInputFile() const noexcept;
+
+  /**
+   * Returns the profiling instrumentation to put in generated code (see
+   * X86Backend).
+   *
+   * @return instrumentation, Instrument::None for none
+   */
+  Instrument getInstrument() const noexcept;
+
+  /**
+   * Returns the file to write the compiled program to, to be run later
+   * (see ObjectFile).
+   *
+   * @return object file, empty for none
+   */
+  const std::string& getObjectFile() const noexcept;
+
+  /**
+   * Returns the file to write generated code to.
+   *
+   * @return output file, empty for stdout
+   */
+  const std::string& getOutputFile() const noexcept;
+
+  /**
+   * Returns how to run the program once compiled.
+   *
+   * @return Execution::None to only generate code
+   */
+  Execution getExecution() const noexcept;
+
+  /**
+   * Returns the names of the optimization passes disabled on the command
+   * line.
+   *
+   * @return disabled pass names
+   */
+  const std::set<std::string>& getDisabledPasses() const noexcept;
+
+  /**
+   * Returns the optimization level: 0 runs no passes, 1 only the cheap local
+   * ones, 2 every pass.
+   *
+   * @return optimization level
+   */
+  int getOptimizationLevel() const noexcept;
+
+  /**
+   * Returns the form of the generated code.
+   *
+   * @return target
+   */
+  Target getTarget() const noexcept;
+
+  /**
+   * Returns if batch execution reads and writes binary records (rather
+   * than text).
+   *
+   * @return true if records are binary
+   */
+  bool isBatchBinary() const noexcept;
+
+  /**
+   * Returns if arithmetic is checked, so a signed overflow stops the
+   * program (rather than wrapping).
+   *
+   * @return true if arithmetic is checked
+   */
+  bool isChecked() const noexcept;
+
+  /**
+   * Returns if generated code should be discarded (i.e., only check the
+   * source for errors).
+   *
+   * @return true if code is to be discarded
+   */
+  bool isCheckOnly() const noexcept;
+
+  /**
+   * Returns if computations which can't affect the output are kept (for
+   * debugging).
+   *
+   * @return true if dead code is neither eliminated nor evaluated away
+   */
+  bool isKeepAll() const noexcept;
+
+  /**
+   * Returns if an optimization pass may be run.
+   *
+   * @param thePass
+   *          pass name (see Pass::getName)
+   * @return false if the pass was disabled on the command line
+   */
+  bool isPassEnabled(const std::string &thePass) const noexcept;
+
+  /**
+   * Returns if the evaluation order of expressions must be preserved (so
+   * intermediate results, and any overflow, are exactly as written). Checked
+   * arithmetic implies it.
+   *
+   * @return true if evaluation order is to be preserved
+   */
+  bool isOrderPreserved() const noexcept;
+
+  /**
+   * Returns if the cost and effect of each optimization pass should be
+   * printed.
+   *
+   * @return true if pass statistics are to be printed
+   */
+  bool isPassStatisticsEnabled() const noexcept;
+
+  /**
+   * Returns if the bytecode interpreter may use superinstructions.
+   *
+   * @return false if they were disabled on the command line
+   */
+  bool isSuperinstructionsEnabled() const noexcept;
+
+  /**
+   * Returns if compilation statistics should be printed.
+   *
+   * @return true if statistics are to be printed
+   */
+  bool isStatisticsEnabled() const noexcept;
+
+  /**
+   * Returns if parse/code generation tracing is enabled.
+   *
+   * @return true if tracing is enabled
+   */
+  bool isTraceEnabled() const noexcept;
+
+  /**
+   * Returns the usage message.
+   *
+   * @param theProgram
+   *          program name
+   * @return usage message
+   */
+  static std::string usage(const std::string &theProgram);
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Batch execution records are binary? */
+  bool myBatchBinary = false;
+
+  /** Stop on integer overflow? */
+  bool myChecked = false;
+
+  /** Discard generated code? */
+  bool myCheckOnly = false;
+
+  /** Keep computations which can't affect the output? */
+  bool myKeepAll = false;
+
+  /** Optimization passes not to run. */
+  std::set<std::string> myDisabledPasses;
+
+  /** How to run the program once compiled. */
+  Execution myExecution = Execution::None;
+
+  /** Source file. */
+  std::string myInputFile;
+
+  /** Profiling instrumentation of generated code. */
+  Instrument myInstrument = Instrument::None;
+
+  /** Object file (empty for none). */
+  std::string myObjectFile;
+
+  /** Optimization level (0 to 2). */
+  int myOptimizationLevel = 2;
+
+  /** Output file (empty for stdout). */
+  std::string myOutputFile;
+
+  /** Print the cost and effect of each optimization pass to stderr? */
+  bool myPassStatistics = false;
+
+  /** Preserve the evaluation order of expressions? */
+  bool myPreserveOrder = false;
+
+  /** Print compilation statistics to stderr? */
+  bool myStatistics = false;
+
+  /** Fuse bytecode operations into superinstructions? */
+  bool mySuperinstructions = true;
+
+  /** Form of the generated code. */
+  Target myTarget = Target::Text;
+
+  /** Trace parsing and code generation on stdout? */
+  bool myTrace = true;
+};
+
+#endif
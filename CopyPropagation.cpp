@@ -0,0 +1,87 @@
+/**
+ * @file CopyPropagation.cpp
+ * @brief Implementation of CopyPropagation class
+ *
+ * @author Michael Albers
+ */
+
+#include "CopyPropagation.h"
+#include "Program.h"
+#include "Statistics.h"
+
+//**************************************************
+// CopyPropagation::getName
+//**************************************************
+const char* CopyPropagation::getName() const noexcept
+{
+  return "copy-propagation";
+}
+
+//**************************************************
+// CopyPropagation::propagateCopies
+//**************************************************
+uint64_t CopyPropagation::propagateCopies(Program &theProgram)
+{
+  auto size = theProgram.getSlotCount();
+
+  // Each assignment to a variable bumps its version, which invalidates any
+  // copies made of its previous value.
+  std::vector<uint32_t> versions(size, 0);
+  std::vector<Copy> copies(size);
+  uint64_t propagated = 0;
+
+  for (auto &instruction : theProgram.getInstructions())
+  {
+    for (uint32_t source = 0; source < instruction.getSourceCount(); ++source)
+    {
+      auto &operand = instruction.getOperand(source);
+      if (! operand.isVariable())
+      {
+        continue;
+      }
+
+      auto &copy = copies[theProgram.getSlot(operand)];
+      if (copy.myValid &&
+          (! copy.mySource.isVariable() ||
+           copy.mySourceVersion ==
+             versions[theProgram.getSlot(copy.mySource)]))
+      {
+        instruction.setOperand(source, copy.mySource);
+        ++propagated;
+      }
+    }
+
+    if (instruction.hasDestination())
+    {
+      auto &destination = instruction.getDestination();
+      auto index = theProgram.getSlot(destination);
+      ++versions[index];
+      copies[index].myValid = false;
+
+      // The source has already been replaced by its own original, so
+      // chains of copies resolve to the first.
+      auto &source = instruction.getOperand(0);
+      if (Instruction::OpCode::Store == instruction.getOpCode() &&
+          source != destination)
+      {
+        copies[index].mySource = source;
+        copies[index].mySourceVersion =
+          source.isVariable() ? versions[theProgram.getSlot(source)] : 0;
+        copies[index].myValid = true;
+      }
+    }
+  }
+  return propagated;
+}
+
+//**************************************************
+// CopyPropagation::run
+//**************************************************
+void CopyPropagation::run(Program &theProgram, AnalysisManager &theAnalyses,
+                          Statistics &theStatistics)
+{
+  auto propagated = propagateCopies(theProgram);
+  setChanged(0 != propagated);
+
+  theStatistics.add("copies propagated", propagated);
+}
@@ -0,0 +1,79 @@
+#ifndef COPYPROPAGATION_H
+#define COPYPROPAGATION_H
+
+/**
+ * @file CopyPropagation.h
+ * @brief Defines the copy propagation pass.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "Operand.h"
+#include "Pass.h"
+
+/**
+ * Copy propagation.
+ *
+ * After "Store X, Y" later reads of Y are replaced by X, until either X or Y
+ * is assigned again. The Stores left unused are deleted by
+ * DeadCodeElimination.
+ */
+class CopyPropagation : public Pass
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  CopyPropagation() = default;
+
+  /**
+   * Destructor
+   */
+  virtual ~CopyPropagation() = default;
+
+  virtual const char* getName() const noexcept override;
+
+  virtual void run(Program &theProgram, AnalysisManager &theAnalyses,
+                   Statistics &theStatistics) override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** A copy, as made by Store. */
+  struct Copy
+  {
+    /** Operand copied (literal or variable). */
+    Operand mySource;
+
+    /** Version of the source variable when it was copied. */
+    uint32_t mySourceVersion = 0;
+
+    /** Is this copy still in effect? */
+    bool myValid = false;
+  };
+
+  /**
+   * Replaces reads of copies with the original.
+   *
+   * @param theProgram
+   *          program to transform
+   * @return number of operands replaced
+   */
+  uint64_t propagateCopies(Program &theProgram);
+};
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file DeadCodeElimination.cpp
+ * @brief Implementation of DeadCodeElimination class
+ *
+ * @author Michael Albers
+ */
+
+#include <vector>
+
+#include "DeadCodeElimination.h"
+#include "Program.h"
+#include "Statistics.h"
+
+//**************************************************
+// DeadCodeElimination::getName
+//**************************************************
+const char* DeadCodeElimination::getName() const noexcept
+{
+  return "dead-code";
+}
+
+//**************************************************
+// DeadCodeElimination::run
+//**************************************************
+void DeadCodeElimination::run(Program &theProgram,
+                              AnalysisManager &theAnalyses,
+                              Statistics &theStatistics)
+{
+  auto &instructions = theProgram.getInstructions();
+  std::vector<bool> live(theProgram.getSlotCount(), false);
+  std::vector<bool> removed(instructions.size(), false);
+  uint64_t removedCount = 0;
+  for (auto ii = instructions.size(); ii-- > 0; )
+  {
+    auto &instruction = instructions[ii];
+    auto opCode = instruction.getOpCode();
+    if (Instruction::OpCode::Declare == opCode)
+    {
+      continue;
+    }
+
+    if (instruction.hasDestination())
+    {
+      auto index = theProgram.getSlot(instruction.getDestination());
+      if (! live[index] && Instruction::OpCode::Read != opCode)
+      {
+        removed[ii] = true;
+        ++removedCount;
+        continue;
+      }
+      live[index] = false;
+    }
+    for (uint32_t source = 0; source < instruction.getSourceCount(); ++source)
+    {
+      auto &operand = instruction.getOperand(source);
+      if (operand.isVariable())
+      {
+        live[theProgram.getSlot(operand)] = true;
+      }
+    }
+  }
+
+  // Symbols still used keep their Declare.
+  std::vector<bool> used(theProgram.getSymbolTable().size(), false);
+  for (std::size_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    auto &instruction = instructions[ii];
+    if (removed[ii] || Instruction::OpCode::Declare == instruction.getOpCode())
+    {
+      continue;
+    }
+    for (uint32_t operand = 0; operand < instruction.getSourceCount() +
+           (instruction.hasDestination() ? 1 : 0); ++operand)
+    {
+      auto &symbol = instruction.getOperand(operand);
+      if (Operand::Kind::Symbol == symbol.getKind())
+      {
+        used[symbol.getIndex()] = true;
+      }
+    }
+  }
+
+  std::size_t kept = 0;
+  for (std::size_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    auto &instruction = instructions[ii];
+    if (Instruction::OpCode::Declare == instruction.getOpCode() &&
+        Operand::Kind::Symbol == instruction.getOperand(0).getKind() &&
+        ! used[instruction.getOperand(0).getIndex()])
+    {
+      removed[ii] = true;
+      ++removedCount;
+    }
+    if (! removed[ii])
+    {
+      instructions[kept++] = instruction;
+    }
+  }
+  instructions.resize(kept);
+  setChanged(0 != removedCount);
+
+  theStatistics.add("dead instructions removed", removedCount);
+}
@@ -0,0 +1,57 @@
+#ifndef DEADCODEELIMINATION_H
+#define DEADCODEELIMINATION_H
+
+/**
+ * @file DeadCodeElimination.h
+ * @brief Defines the dead code elimination pass.
+ *
+ * @author Michael Albers
+ */
+
+#include "Pass.h"
+
+/**
+ * Deletes computations which can't affect the program's output.
+ *
+ * Liveness is found in one backward scan of the (straight-line) program:
+ * nothing is live at Halt, Write makes its operand live, and any other
+ * assignment kills its destination and, if that destination was live,
+ * makes its sources live. An assignment (Store, Add, Sub, Mul or Pow) to a
+ * variable not live after it is deleted. Read is never deleted, nor moved:
+ * it consumes input, so later Reads depend on it. Finally the Declare of
+ * each symbol no longer used anywhere is deleted.
+ */
+class DeadCodeElimination : public Pass
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  DeadCodeElimination() = default;
+
+  /**
+   * Destructor
+   */
+  virtual ~DeadCodeElimination() = default;
+
+  virtual const char* getName() const noexcept override;
+
+  virtual void run(Program &theProgram, AnalysisManager &theAnalyses,
+                   Statistics &theStatistics) override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+};
+
+#endif
@@ -65,3 +65,11 @@ void ErrorWarningTracker::reportError(
             << theErrorToken.getColumn() << ": error: " << theError
             << std::endl;
 }
+
+//*********************************
+// ErrorWarningTracker::reportWarning
+//*********************************
+void ErrorWarningTracker::reportWarning(const std::string &theWarning) noexcept
+{
+  std::cerr << myFile << ": warning: " << theWarning << std::endl;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file ExecutableMemory.cpp
+ * @brief Implementation of ExecutableMemory class
+ *
+ * @author Michael Albers
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "ExecutableMemory.h"
+
+//**************************************************
+// ExecutableMemory::ExecutableMemory
+//**************************************************
+ExecutableMemory::ExecutableMemory(const std::vector<uint8_t> &theCode)
+{
+  std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+  mySize = (theCode.size() + pageSize - 1) / pageSize * pageSize;
+  if (0 == mySize)
+  {
+    mySize = pageSize;
+  }
+
+  myAddress = ::mmap(nullptr, mySize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (MAP_FAILED == myAddress)
+  {
+    auto localErrno = errno;
+    throw std::runtime_error(std::string("Failed to map code memory: ") +
+                             std::strerror(localErrno));
+  }
+
+  std::memcpy(myAddress, theCode.data(), theCode.size());
+  if (0 != ::mprotect(myAddress, mySize, PROT_READ | PROT_EXEC))
+  {
+    auto localErrno = errno;
+    ::munmap(myAddress, mySize);
+    throw std::runtime_error(
+      std::string("Failed to make code memory executable: ") +
+      std::strerror(localErrno));
+  }
+}
+
+//**************************************************
+// ExecutableMemory::~ExecutableMemory
+//**************************************************
+ExecutableMemory::~ExecutableMemory()
+{
+  ::munmap(myAddress, mySize);
+}
+
+//**************************************************
+// ExecutableMemory::getAddress
+//**************************************************
+const void* ExecutableMemory::getAddress() const noexcept
+{
+  return myAddress;
+}
+
+//**************************************************
+// ExecutableMemory::getSize
+//**************************************************
+std::size_t ExecutableMemory::getSize() const noexcept
+{
+  return mySize;
+}
@@ -0,0 +1,99 @@
+#ifndef EXECUTABLEMEMORY_H
+#define EXECUTABLEMEMORY_H
+
+/**
+ * @file ExecutableMemory.h
+ * @brief Defines the holder of machine code mapped for execution.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Pages of machine code. The code is copied into pages mapped writable,
+ * which are then remapped read-only and executable before anything can run
+ * (W^X: never writable and executable at once). The pages are unmapped
+ * when the object is destroyed.
+ */
+class ExecutableMemory
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  ExecutableMemory() = delete;
+
+  /**
+   * Constructor. Maps the code.
+   *
+   * @param theCode
+   *          machine code
+   * @throws std::runtime_error
+   *           if the memory can't be mapped
+   */
+  explicit ExecutableMemory(const std::vector<uint8_t> &theCode);
+
+  /**
+   * Copy constructor
+   */
+  ExecutableMemory(const ExecutableMemory &) = delete;
+
+  /**
+   * Move constructor
+   */
+  ExecutableMemory(ExecutableMemory &&) = delete;
+
+  /**
+   * Destructor
+   */
+  ~ExecutableMemory();
+
+  /**
+   * Copy assignment operator
+   */
+  ExecutableMemory& operator=(const ExecutableMemory &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  ExecutableMemory& operator=(ExecutableMemory &&) = delete;
+
+  /**
+   * Returns the address of the first byte of code.
+   *
+   * @return code address
+   */
+  const void* getAddress() const noexcept;
+
+  /**
+   * Returns the size of the mapping.
+   *
+   * @return size, in bytes (whole pages)
+   */
+  std::size_t getSize() const noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Start of the mapping. */
+  void *myAddress;
+
+  /** Size of the mapping. */
+  std::size_t mySize;
+};
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * @file ExpressionDAG.cpp
+ * @brief Implementation of ExpressionDAG class
+ *
+ * @author Michael Albers
+ */
+
+#include <utility>
+
+#include "ExpressionDAG.h"
+
+//**************************************************
+// ExpressionDAG::assign
+//**************************************************
+void ExpressionDAG::assign(const Operand &theSymbol)
+{
+  getVersion(theSymbol.getIndex());
+  ++myVersions[theSymbol.getIndex()];
+}
+
+//**************************************************
+// ExpressionDAG::getLeaf
+//**************************************************
+uint32_t ExpressionDAG::getLeaf(const Operand &theOperand)
+{
+  uint32_t version = 0;
+  std::pair<uint32_t, bool> entry;
+  if (Operand::Kind::Literal == theOperand.getKind())
+  {
+    auto literal = myLiteralNodes.emplace(theOperand.getValue(),
+                                          myNodes.size());
+    entry = std::make_pair(literal.first->second, literal.second);
+  }
+  else
+  {
+    uint64_t key = (static_cast<uint64_t>(theOperand.getIndex()) << 1) | 1;
+    if (Operand::Kind::Symbol == theOperand.getKind())
+    {
+      version = getVersion(theOperand.getIndex());
+      key = (static_cast<uint64_t>(theOperand.getIndex()) << 33) |
+        (static_cast<uint64_t>(version) << 1);
+    }
+    auto leaf = myLeafNodes.emplace(key, myNodes.size());
+    entry = std::make_pair(leaf.first->second, leaf.second);
+  }
+  if (! entry.second)
+  {
+    return entry.first;
+  }
+
+  Node node;
+  node.myOpCode = Instruction::OpCode::Store;
+  node.myLeaf = true;
+  node.myOperands[0] = node.myOperands[1] = 0;
+  node.myResult = theOperand;
+  node.myVersion = version;
+  myNodes.push_back(node);
+  return myNodes.size() - 1;
+}
+
+//**************************************************
+// ExpressionDAG::getLeft
+//**************************************************
+uint32_t ExpressionDAG::getLeft(uint32_t theNode) const noexcept
+{
+  return myNodes[theNode].myOperands[0];
+}
+
+//**************************************************
+// ExpressionDAG::getLookupCount
+//**************************************************
+uint64_t ExpressionDAG::getLookupCount() const noexcept
+{
+  return myLookups;
+}
+
+//**************************************************
+// ExpressionDAG::getNode
+//**************************************************
+uint32_t ExpressionDAG::getNode(Instruction::OpCode theOpCode,
+                                uint32_t theLeft, uint32_t theRight)
+{
+  ++myLookups;
+  // Operands of commutative operations are put in a canonical order for
+  // the key; the node keeps the order first seen.
+  auto first = theLeft;
+  auto second = theRight;
+  if ((Instruction::OpCode::Add == theOpCode ||
+       Instruction::OpCode::Mul == theOpCode) && first > second)
+  {
+    std::swap(first, second);
+  }
+
+  uint64_t key = (static_cast<uint64_t>(first) << 33) |
+    (static_cast<uint64_t>(second) << 3) |
+    static_cast<uint64_t>(theOpCode);
+  auto entry = myInteriorNodes.emplace(key, myNodes.size());
+  if (! entry.second)
+  {
+    return entry.first->second;
+  }
+
+  Node node;
+  node.myOpCode = theOpCode;
+  node.myLeaf = false;
+  node.myOperands[0] = theLeft;
+  node.myOperands[1] = theRight;
+  node.myVersion = 0;
+  myNodes.push_back(node);
+  return myNodes.size() - 1;
+}
+
+//**************************************************
+// ExpressionDAG::getNodeCount
+//**************************************************
+uint64_t ExpressionDAG::getNodeCount() const noexcept
+{
+  return myInteriorNodes.size();
+}
+
+//**************************************************
+// ExpressionDAG::getOpCode
+//**************************************************
+Instruction::OpCode ExpressionDAG::getOpCode(uint32_t theNode) const noexcept
+{
+  return myNodes[theNode].myOpCode;
+}
+
+//**************************************************
+// ExpressionDAG::getResult
+//**************************************************
+Operand ExpressionDAG::getResult(uint32_t theNode) const noexcept
+{
+  auto &node = myNodes[theNode];
+  if (! node.myLeaf && Operand::Kind::Symbol == node.myResult.getKind() &&
+      node.myVersion != myVersions[node.myResult.getIndex()])
+  {
+    // The symbol has since been assigned something else.
+    return Operand();
+  }
+  return node.myResult;
+}
+
+//**************************************************
+// ExpressionDAG::getRight
+//**************************************************
+uint32_t ExpressionDAG::getRight(uint32_t theNode) const noexcept
+{
+  return myNodes[theNode].myOperands[1];
+}
+
+//**************************************************
+// ExpressionDAG::getVersion
+//**************************************************
+uint32_t ExpressionDAG::getVersion(uint32_t theSymbol)
+{
+  if (theSymbol >= myVersions.size())
+  {
+    myVersions.resize(theSymbol + 1, 0);
+  }
+  return myVersions[theSymbol];
+}
+
+//**************************************************
+// ExpressionDAG::isLeaf
+//**************************************************
+bool ExpressionDAG::isLeaf(uint32_t theNode) const noexcept
+{
+  return myNodes[theNode].myLeaf;
+}
+
+//**************************************************
+// ExpressionDAG::setResult
+//**************************************************
+void ExpressionDAG::setResult(uint32_t theNode, const Operand &theResult)
+{
+  auto &node = myNodes[theNode];
+  node.myResult = theResult;
+  node.myVersion = (Operand::Kind::Symbol == theResult.getKind()) ?
+    getVersion(theResult.getIndex()) : 0;
+}
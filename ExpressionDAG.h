@@ -0,0 +1,230 @@
+#ifndef EXPRESSIONDAG_H
+#define EXPRESSIONDAG_H
+
+/**
+ * @file ExpressionDAG.h
+ * @brief Defines the hash-consed graph of expressions built while parsing.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Instruction.h"
+#include "Operand.h"
+
+/**
+ * Directed acyclic graph of every expression parsed so far. Nodes are hash
+ * consed: a node is keyed by its op code and the node numbers of its
+ * operands (which act as value numbers), so an expression seen twice, in
+ * the same statement or a later one, is the same node. Leaves are literals,
+ * temporaries and symbols; a symbol leaf is for one version of the symbol,
+ * a new version starting each time the symbol is assigned, so expressions
+ * using its old value are never confused with ones using its new value.
+ *
+ * The code generator emits code for a node, and any operand nodes not
+ * already emitted, when the expression is used (see CodeGenerator). Each
+ * node remembers where its value was left so it is only computed once.
+ */
+class ExpressionDAG
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  ExpressionDAG() = default;
+
+  /**
+   * Copy constructor
+   */
+  ExpressionDAG(const ExpressionDAG &) = default;
+
+  /**
+   * Move constructor
+   */
+  ExpressionDAG(ExpressionDAG &&) = default;
+
+  /**
+   * Destructor
+   */
+  ~ExpressionDAG() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  ExpressionDAG& operator=(const ExpressionDAG &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  ExpressionDAG& operator=(ExpressionDAG &&) = default;
+
+  /**
+   * Starts a new version of a symbol (it is about to be assigned).
+   *
+   * @param theSymbol
+   *          symbol
+   */
+  void assign(const Operand &theSymbol);
+
+  /**
+   * Returns the leaf node for an operand (for a symbol, its current
+   * version), adding it if needed.
+   *
+   * @param theOperand
+   *          literal, symbol or temporary
+   * @return node number
+   */
+  uint32_t getLeaf(const Operand &theOperand);
+
+  /**
+   * Returns the left operand node of an interior node.
+   *
+   * @param theNode
+   *          node number
+   * @return node number
+   */
+  uint32_t getLeft(uint32_t theNode) const noexcept;
+
+  /**
+   * Returns the node applying an operation to two nodes, adding it if
+   * needed.
+   *
+   * @param theOpCode
+   *          operation (Add, Sub, Mul or Pow)
+   * @param theLeft
+   *          left operand node
+   * @param theRight
+   *          right operand node
+   * @return node number
+   */
+  uint32_t getNode(Instruction::OpCode theOpCode, uint32_t theLeft,
+                   uint32_t theRight);
+
+  /**
+   * Returns the operation of an interior node.
+   *
+   * @param theNode
+   *          node number
+   * @return op code
+   */
+  Instruction::OpCode getOpCode(uint32_t theNode) const noexcept;
+
+  /**
+   * Returns where the value of a node can be read. Always the operand for a
+   * leaf. For an interior node, where its value was left when last emitted,
+   * or nothing (Operand::Kind::None) if it must be computed (again).
+   *
+   * @param theNode
+   *          node number
+   * @return operand holding the node's value
+   */
+  Operand getResult(uint32_t theNode) const noexcept;
+
+  /**
+   * Returns the right operand node of an interior node.
+   *
+   * @param theNode
+   *          node number
+   * @return node number
+   */
+  uint32_t getRight(uint32_t theNode) const noexcept;
+
+  /**
+   * Returns the number of interior node lookups (see getNode).
+   *
+   * @return number of lookups
+   */
+  uint64_t getLookupCount() const noexcept;
+
+  /**
+   * Returns the number of interior nodes.
+   *
+   * @return number of nodes
+   */
+  uint64_t getNodeCount() const noexcept;
+
+  /**
+   * Returns if a node is a leaf.
+   *
+   * @param theNode
+   *          node number
+   * @return true for a leaf
+   */
+  bool isLeaf(uint32_t theNode) const noexcept;
+
+  /**
+   * Records where the value of an interior node has been left. A symbol
+   * holds it until the symbol is next assigned.
+   *
+   * @param theNode
+   *          node number
+   * @param theResult
+   *          temporary or symbol holding the value
+   */
+  void setResult(uint32_t theNode, const Operand &theResult);
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** A node. */
+  struct Node
+  {
+    /** Operation (interior nodes). */
+    Instruction::OpCode myOpCode;
+
+    /** Is this a leaf? */
+    bool myLeaf;
+
+    /** Left and right operand nodes (interior nodes). */
+    uint32_t myOperands[2];
+
+    /** Leaf operand, or where the value was left (interior nodes). */
+    Operand myResult;
+
+    /** Version of the symbol in myResult. */
+    uint32_t myVersion;
+  };
+
+  /**
+   * Returns the current version of a symbol.
+   *
+   * @param theSymbol
+   *          symbol index
+   * @return version
+   */
+  uint32_t getVersion(uint32_t theSymbol);
+
+  /** Interior nodes, keyed by op code and operand nodes. */
+  std::unordered_map<uint64_t, uint32_t> myInteriorNodes;
+
+  /** Leaf nodes, keyed by operand kind, value and version. */
+  std::unordered_map<uint64_t, uint32_t> myLeafNodes;
+
+  /** Literal leaf nodes, keyed by value. */
+  std::unordered_map<int64_t, uint32_t> myLiteralNodes;
+
+  /** Number of interior node lookups. */
+  uint64_t myLookups = 0;
+
+  /** All nodes. */
+  std::vector<Node> myNodes;
+
+  /** Current version of each symbol. */
+  std::vector<uint32_t> myVersions;
+};
+
+#endif
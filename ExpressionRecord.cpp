@@ -19,11 +19,67 @@ ExpressionRecord::ExpressionRecord() :
 // ExpressionRecord::ExpressionRecord
 //**************************************************
 ExpressionRecord::ExpressionRecord(Type theType, const std::string &theValue) :
+  ExpressionRecord(theType, theValue, 0)
+{
+}
+
+//**************************************************
+// ExpressionRecord::ExpressionRecord
+//**************************************************
+ExpressionRecord::ExpressionRecord(Type theType, const std::string &theValue,
+                                   uint32_t theIndex) :
+  myIndex(theIndex),
   myType(theType),
   myValue(theValue)
 {
 }
 
+//**************************************************
+// ExpressionRecord::getIndex
+//**************************************************
+uint32_t ExpressionRecord::getIndex() const noexcept
+{
+  return myIndex;
+}
+
+//**************************************************
+// ExpressionRecord::getLiteralValue
+//**************************************************
+bool ExpressionRecord::getLiteralValue(int64_t &theValue) const noexcept
+{
+  if (myType != Type::Literal || myValue.empty())
+  {
+    return false;
+  }
+
+  // Folded literals can be negative, source literals never are.
+  bool negative = ('-' == myValue[0]);
+  auto digit = myValue.begin() + (negative ? 1 : 0);
+  if (digit == myValue.end())
+  {
+    return false;
+  }
+
+  // Accumulate as a negative number so INT64_MIN can be represented.
+  int64_t value = 0;
+  for (; digit != myValue.end(); ++digit)
+  {
+    if (*digit < '0' || *digit > '9' ||
+        __builtin_mul_overflow(value, 10, &value) ||
+        __builtin_sub_overflow(value, *digit - '0', &value))
+    {
+      return false;
+    }
+  }
+
+  if (! negative && __builtin_mul_overflow(value, -1, &value))
+  {
+    return false;
+  }
+  theValue = value;
+  return true;
+}
+
 //**************************************************
 // ExpressionRecord::getType
 //**************************************************
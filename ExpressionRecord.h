@@ -8,6 +8,7 @@
  * @author Michael Albers
  */
 
+#include <cstdint>
 #include <string>
 
 /**
@@ -24,7 +25,8 @@ class ExpressionRecord
   {
     Id,
     Literal,
-    Temporary
+    Temporary,
+    Node
   };
 
   /**
@@ -52,6 +54,20 @@ class ExpressionRecord
    */
   ExpressionRecord(Type theType, const std::string &theValue);
 
+  /**
+   * Constructor
+   *
+   * @param theType
+   *          type of expression
+   * @param theValue
+   *          expression value
+   * @param theIndex
+   *          symbol index (Id), temporary number (Temporary) or
+   *          expression node number (Node, see ExpressionDAG)
+   */
+  ExpressionRecord(Type theType, const std::string &theValue,
+                   uint32_t theIndex);
+
   /**
    * Destructor
    */
@@ -75,6 +91,24 @@ class ExpressionRecord
    */
   ExpressionRecord& operator=(ExpressionRecord &&theRHS) = default;
 
+  /**
+   * Returns the symbol index (Id), temporary number (Temporary) or
+   * expression node number (Node).
+   *
+   * @return expression index
+   */
+  uint32_t getIndex() const noexcept;
+
+  /**
+   * Converts the value of a literal expression to an integer.
+   *
+   * @param theValue
+   *          set to the value of the literal on success
+   * @return false if this isn't a literal or the literal doesn't fit in a
+   *         64-bit signed integer, otherwise true
+   */
+  bool getLiteralValue(int64_t &theValue) const noexcept;
+
   /**
    * Returns the expression type.
    *
@@ -99,6 +133,9 @@ class ExpressionRecord
   // ************************************************************
   private:
 
+  /** Symbol index, temporary number or expression node number. */
+  uint32_t myIndex;
+
   /** Expression type. */
   Type myType;
 
@@ -0,0 +1,139 @@
+/**
+ * @file FileDescriptorSink.cpp
+ * @brief Implementation of FileDescriptorSink class
+ *
+ * @author Michael Albers
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "FileDescriptorSink.h"
+
+//**************************************************
+// FileDescriptorSink::FileDescriptorSink
+//**************************************************
+FileDescriptorSink::FileDescriptorSink(int theFileDescriptor) :
+  myBuffer(BUFFER_SIZE),
+  myFileDescriptor(theFileDescriptor),
+  myName("file descriptor " + std::to_string(theFileDescriptor)),
+  myOwnsDescriptor(false)
+{
+}
+
+//**************************************************
+// FileDescriptorSink::FileDescriptorSink
+//**************************************************
+FileDescriptorSink::FileDescriptorSink(const std::string &theFile) :
+  myBuffer(BUFFER_SIZE),
+  myFileDescriptor(::open(theFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                          0644)),
+  myName(theFile),
+  myOwnsDescriptor(true)
+{
+  if (myFileDescriptor < 0)
+  {
+    auto localErrno = errno;
+    throw std::runtime_error("Failed to open '" + myName + "': " +
+                             std::strerror(localErrno));
+  }
+}
+
+//**************************************************
+// FileDescriptorSink::~FileDescriptorSink
+//**************************************************
+FileDescriptorSink::~FileDescriptorSink()
+{
+  drain(nullptr, 0);
+  if (myOwnsDescriptor)
+  {
+    ::close(myFileDescriptor);
+  }
+}
+
+//**************************************************
+// FileDescriptorSink::drain
+//**************************************************
+void FileDescriptorSink::drain(const char *theData, std::size_t theLength)
+  noexcept
+{
+  struct iovec vectors[2];
+  vectors[0].iov_base = myBuffer.data();
+  vectors[0].iov_len = myBufferUsed;
+  vectors[1].iov_base = const_cast<char*>(theData);
+  vectors[1].iov_len = theLength;
+  myBufferUsed = 0;
+
+  // Skip empty leading vectors, then keep going until everything is written
+  // (writev may write less than requested, e.g. to a pipe).
+  struct iovec *vector = vectors;
+  int count = 2;
+  while (count > 0 && 0 == myErrno)
+  {
+    if (0 == vector->iov_len)
+    {
+      ++vector;
+      --count;
+      continue;
+    }
+
+    auto written = ::writev(myFileDescriptor, vector, count);
+    if (written < 0)
+    {
+      if (EINTR != errno)
+      {
+        myErrno = errno;
+      }
+      continue;
+    }
+
+    while (count > 0 && static_cast<std::size_t>(written) >= vector->iov_len)
+    {
+      written -= vector->iov_len;
+      ++vector;
+      --count;
+    }
+    if (count > 0)
+    {
+      vector->iov_base = static_cast<char*>(vector->iov_base) + written;
+      vector->iov_len -= written;
+    }
+  }
+}
+
+//**************************************************
+// FileDescriptorSink::flush
+//**************************************************
+void FileDescriptorSink::flush()
+{
+  drain(nullptr, 0);
+  if (0 != myErrno)
+  {
+    throw std::runtime_error("Failed to write '" + myName + "': " +
+                             std::strerror(myErrno));
+  }
+}
+
+//**************************************************
+// FileDescriptorSink::write
+//**************************************************
+void FileDescriptorSink::write(const char *theData, std::size_t theLength)
+  noexcept
+{
+  if (myBufferUsed + theLength <= myBuffer.size())
+  {
+    std::memcpy(myBuffer.data() + myBufferUsed, theData, theLength);
+    myBufferUsed += theLength;
+  }
+  else
+  {
+    // Send the buffer and the new data in a single system call rather than
+    // copying the new data through the buffer.
+    drain(theData, theLength);
+  }
+}
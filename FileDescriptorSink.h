@@ -0,0 +1,107 @@
+#ifndef FILEDESCRIPTORSINK_H
+#define FILEDESCRIPTORSINK_H
+
+/**
+ * @file FileDescriptorSink.h
+ * @brief Defines a sink which writes to a file descriptor.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "OutputSink.h"
+
+/**
+ * Buffered sink writing to a file descriptor. Output is collected in a large
+ * buffer and handed to the kernel with one write()/writev() per buffer, so
+ * memory use is constant regardless of the amount of code generated.
+ */
+class FileDescriptorSink : public OutputSink
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  FileDescriptorSink() = delete;
+
+  /**
+   * Constructor. The descriptor is not closed by this object.
+   *
+   * @param theFileDescriptor
+   *          open, writable file descriptor
+   */
+  FileDescriptorSink(int theFileDescriptor);
+
+  /**
+   * Constructor. Creates (or truncates) the given file.
+   *
+   * @param theFile
+   *          file to write
+   * @throws std::runtime_error
+   *           on error opening the file
+   */
+  FileDescriptorSink(const std::string &theFile);
+
+  /**
+   * Destructor. Flushes any remaining output (errors are ignored, call flush
+   * beforehand to detect them).
+   */
+  virtual ~FileDescriptorSink();
+
+  virtual void flush() override;
+
+  using OutputSink::write;
+
+  virtual void write(const char *theData, std::size_t theLength)
+    noexcept override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Size of the write buffer. */
+  static constexpr std::size_t BUFFER_SIZE = 256 * 1024;
+
+  /**
+   * Writes the buffer, followed by the given data, to the file descriptor.
+   *
+   * @param theData
+   *          data to write after the buffer (may be null)
+   * @param theLength
+   *          number of bytes in theData
+   */
+  void drain(const char *theData, std::size_t theLength) noexcept;
+
+  /** Buffered output. */
+  std::vector<char> myBuffer;
+
+  /** Number of bytes used in myBuffer. */
+  std::size_t myBufferUsed = 0;
+
+  /** errno of the first failed write, 0 if none. */
+  int myErrno = 0;
+
+  /** Output file descriptor. */
+  int myFileDescriptor;
+
+  /** Name of the output file, for error messages. */
+  std::string myName;
+
+  /** Does this object own (and need to close) the descriptor? */
+  bool myOwnsDescriptor;
+};
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file Instruction.cpp
+ * @brief Implementation of Instruction class
+ *
+ * @author Michael Albers
+ */
+
+#include "Instruction.h"
+
+//**************************************************
+// Instruction::Instruction
+//**************************************************
+Instruction::Instruction(OpCode theOpCode,
+                         const Operand &theFirst,
+                         const Operand &theSecond,
+                         const Operand &theThird) :
+  myOpCode(theOpCode),
+  myOperands{theFirst, theSecond, theThird}
+{
+}
+
+//**************************************************
+// Instruction::getDestination
+//**************************************************
+const Operand& Instruction::getDestination() const noexcept
+{
+  return myOperands[getDestinationIndex()];
+}
+
+//**************************************************
+// Instruction::getDestinationIndex
+//**************************************************
+uint32_t Instruction::getDestinationIndex() const noexcept
+{
+  // Sources come first, so the destination follows them.
+  return getSourceCount();
+}
+
+//**************************************************
+// Instruction::getLine
+//**************************************************
+uint32_t Instruction::getLine() const noexcept
+{
+  return myLine;
+}
+
+//**************************************************
+// Instruction::getOpCode
+//**************************************************
+Instruction::OpCode Instruction::getOpCode() const noexcept
+{
+  return myOpCode;
+}
+
+//**************************************************
+// Instruction::getOperand
+//**************************************************
+const Operand& Instruction::getOperand(uint32_t theIndex) const noexcept
+{
+  return myOperands[theIndex];
+}
+
+//**************************************************
+// Instruction::getSourceCount
+//**************************************************
+uint32_t Instruction::getSourceCount() const noexcept
+{
+  switch (myOpCode)
+  {
+    case OpCode::Write:
+    case OpCode::Store:
+      return 1;
+
+    case OpCode::Add:
+    case OpCode::Sub:
+    case OpCode::Mul:
+    case OpCode::Pow:
+      return 2;
+
+    default:
+      return 0;
+  }
+}
+
+//**************************************************
+// Instruction::hasDestination
+//**************************************************
+bool Instruction::hasDestination() const noexcept
+{
+  switch (myOpCode)
+  {
+    case OpCode::Read:
+    case OpCode::Store:
+    case OpCode::Add:
+    case OpCode::Sub:
+    case OpCode::Mul:
+    case OpCode::Pow:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+//**************************************************
+// Instruction::setDestination
+//**************************************************
+void Instruction::setDestination(const Operand &theDestination) noexcept
+{
+  myOperands[getDestinationIndex()] = theDestination;
+}
+
+//**************************************************
+// Instruction::setLine
+//**************************************************
+void Instruction::setLine(uint32_t theLine) noexcept
+{
+  myLine = theLine;
+}
+
+//**************************************************
+// Instruction::setOperand
+//**************************************************
+void Instruction::setOperand(uint32_t theIndex,
+                             const Operand &theOperand) noexcept
+{
+  myOperands[theIndex] = theOperand;
+}
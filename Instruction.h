@@ -0,0 +1,200 @@
+#ifndef INSTRUCTION_H
+#define INSTRUCTION_H
+
+/**
+ * @file Instruction.h
+ * @brief Defines an intermediate code instruction.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+
+#include "Operand.h"
+
+/**
+ * A single intermediate code instruction. Operand layout by op code:
+ *
+ *   Declare  symbol
+ *   Read     destination
+ *   Write    source
+ *   Store    source, destination
+ *   Add      source, source, destination
+ *   Sub      source, source, destination
+ *   Mul      source, source, destination
+ *   Pow      source, source, destination (source ** source)
+ *   Halt
+ *
+ * Sources always come first, so source N is operand N.
+ */
+class Instruction
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** All instructions */
+  enum class OpCode : uint8_t
+  {
+    Declare,
+    Read,
+    Write,
+    Store,
+    Add,
+    Sub,
+    Mul,
+    Pow,
+    Halt
+  };
+
+  /** Maximum number of operands of any instruction. */
+  static constexpr uint32_t MAX_OPERANDS = 3;
+
+  /**
+   * Default constructor. Creates a Halt instruction.
+   */
+  Instruction() = default;
+
+  /**
+   * Copy constructor
+   */
+  Instruction(const Instruction &) = default;
+
+  /**
+   * Move constructor
+   */
+  Instruction(Instruction &&) = default;
+
+  /**
+   * Constructor
+   *
+   * @param theOpCode
+   *          instruction op code
+   * @param theFirst
+   *          first operand
+   * @param theSecond
+   *          second operand
+   * @param theThird
+   *          third operand
+   */
+  Instruction(OpCode theOpCode,
+              const Operand &theFirst = Operand(),
+              const Operand &theSecond = Operand(),
+              const Operand &theThird = Operand());
+
+  /**
+   * Destructor
+   */
+  ~Instruction() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  Instruction& operator=(const Instruction &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  Instruction& operator=(Instruction &&) = default;
+
+  /**
+   * Returns the operand written by this instruction. Only valid if
+   * hasDestination is true.
+   *
+   * @return destination operand
+   */
+  const Operand& getDestination() const noexcept;
+
+  /**
+   * Returns the source line the instruction was generated for.
+   *
+   * @return line, 0 if unknown
+   */
+  uint32_t getLine() const noexcept;
+
+  /**
+   * Returns the instruction op code.
+   *
+   * @return op code
+   */
+  OpCode getOpCode() const noexcept;
+
+  /**
+   * Returns an operand.
+   *
+   * @param theIndex
+   *          operand number (0 to MAX_OPERANDS - 1)
+   * @return operand
+   */
+  const Operand& getOperand(uint32_t theIndex) const noexcept;
+
+  /**
+   * Returns the number of operands read by this instruction.
+   *
+   * @return number of source operands
+   */
+  uint32_t getSourceCount() const noexcept;
+
+  /**
+   * Returns if this instruction writes to an operand.
+   *
+   * @return true if there is a destination operand
+   */
+  bool hasDestination() const noexcept;
+
+  /**
+   * Replaces the destination operand. Only valid if hasDestination is true.
+   *
+   * @param theDestination
+   *          new destination
+   */
+  void setDestination(const Operand &theDestination) noexcept;
+
+  /**
+   * Sets the source line the instruction was generated for (used to report
+   * run time errors).
+   *
+   * @param theLine
+   *          line
+   */
+  void setLine(uint32_t theLine) noexcept;
+
+  /**
+   * Replaces an operand.
+   *
+   * @param theIndex
+   *          operand number (0 to MAX_OPERANDS - 1)
+   * @param theOperand
+   *          new operand
+   */
+  void setOperand(uint32_t theIndex, const Operand &theOperand) noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Returns the position of the destination operand.
+   *
+   * @return destination operand number
+   */
+  uint32_t getDestinationIndex() const noexcept;
+
+  /** Source line. */
+  uint32_t myLine = 0;
+
+  /** Op code. */
+  OpCode myOpCode = OpCode::Halt;
+
+  /** Operands. */
+  Operand myOperands[MAX_OPERANDS];
+};
+
+#endif
@@ -0,0 +1,366 @@
+/**
+ * @file JitBackend.cpp
+ * @brief Implementation of JitBackend class
+ *
+ * @author Michael Albers
+ */
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "JitBackend.h"
+#include "Program.h"
+#include "Runtime.h"
+
+constexpr uint32_t JitBackend::NO_SLOT;
+
+//**************************************************
+// JitBackend::compile
+//**************************************************
+void JitBackend::compile(const Program &theProgram, bool theChecked)
+{
+#ifndef __x86_64__
+  throw std::runtime_error("The JIT only generates x86-64 code.");
+#endif
+
+  mySymbolCount = theProgram.getSymbolTable().size();
+  myFrameSize = mySymbolCount + theProgram.getTemporaryCount() + 1;
+  myAccumulator = NO_SLOT;
+  myCode.clear();
+  myTraps.clear();
+  myCode.reserve(16 * theProgram.getInstructions().size() + 32);
+
+  // push %rbx; push %r12; sub $8, %rsp (realigns the stack for calls);
+  // mov %rdi, %rbx (frame); mov %rsi, %r12 (callbacks)
+  emit({0x53, 0x41, 0x54, 0x48, 0x83, 0xEC, 0x08,
+        0x48, 0x89, 0xFB, 0x49, 0x89, 0xF4});
+
+  for (auto &instruction : theProgram.getInstructions())
+  {
+    switch (instruction.getOpCode())
+    {
+      case Instruction::OpCode::Declare:
+      case Instruction::OpCode::Halt:
+        break;
+
+      case Instruction::OpCode::Read:
+        emitCall(offsetof(Callbacks, myRead), true);
+        emitStore(instruction.getOperand(0));
+        break;
+
+      case Instruction::OpCode::Write:
+        emitLoad(instruction.getOperand(0));
+        // mov %rax, %rsi
+        emit({0x48, 0x89, 0xC6});
+        emitCall(offsetof(Callbacks, myWrite), true);
+        break;
+
+      case Instruction::OpCode::Store:
+        emitLoad(instruction.getOperand(0));
+        emitStore(instruction.getOperand(1));
+        break;
+
+      case Instruction::OpCode::Add:
+      case Instruction::OpCode::Sub:
+      case Instruction::OpCode::Mul:
+        emitLoad(instruction.getOperand(0));
+        emitArithmetic(instruction.getOpCode(), instruction.getOperand(1));
+        if (theChecked)
+        {
+          emitOverflowCheck(instruction.getLine());
+        }
+        emitStore(instruction.getOperand(2));
+        break;
+
+      case Instruction::OpCode::Pow:
+        emitLoad(instruction.getOperand(1));
+        // mov %rax, %rsi
+        emit({0x48, 0x89, 0xC6});
+        emitLoad(instruction.getOperand(0));
+        // mov %rax, %rdi
+        emit({0x48, 0x89, 0xC7});
+        if (theChecked)
+        {
+          // mov $line, %edx
+          emit({0xBA});
+          emitImmediate(instruction.getLine(), 4);
+          emitCall(offsetof(Callbacks, myCheckedPower), false);
+        }
+        else
+        {
+          emitCall(offsetof(Callbacks, myPower), false);
+        }
+        emitStore(instruction.getOperand(2));
+        break;
+    }
+  }
+
+  // add $8, %rsp; pop %r12; pop %rbx; ret
+  emit({0x48, 0x83, 0xC4, 0x08, 0x41, 0x5C, 0x5B, 0xC3});
+
+  myMemory.reset(new ExecutableMemory(myCode));
+}
+
+//**************************************************
+// JitBackend::emit
+//**************************************************
+void JitBackend::emit(std::initializer_list<uint8_t> theBytes)
+{
+  myCode.insert(myCode.end(), theBytes);
+}
+
+//**************************************************
+// JitBackend::emitArithmetic
+//**************************************************
+void JitBackend::emitArithmetic(Instruction::OpCode theOpCode,
+                                const Operand &theOperand)
+{
+  myAccumulator = NO_SLOT;
+  auto slot = slotOf(theOperand);
+  if (NO_SLOT != slot)
+  {
+    // op disp32(%rbx), %rax
+    switch (theOpCode)
+    {
+      case Instruction::OpCode::Add:
+        emit({0x48, 0x03, 0x83});
+        break;
+
+      case Instruction::OpCode::Sub:
+        emit({0x48, 0x2B, 0x83});
+        break;
+
+      default:
+        emit({0x48, 0x0F, 0xAF, 0x83});
+        break;
+    }
+    emitImmediate(8 * slot, 4);
+    return;
+  }
+
+  auto value = theOperand.getValue();
+  if (value >= INT32_MIN && value <= INT32_MAX)
+  {
+    // op $imm32, %rax
+    switch (theOpCode)
+    {
+      case Instruction::OpCode::Add:
+        emit({0x48, 0x05});
+        break;
+
+      case Instruction::OpCode::Sub:
+        emit({0x48, 0x2D});
+        break;
+
+      default:
+        emit({0x48, 0x69, 0xC0});
+        break;
+    }
+    emitImmediate(value, 4);
+    return;
+  }
+
+  // movabs $imm64, %rdx; op %rdx, %rax
+  emit({0x48, 0xBA});
+  emitImmediate(value, 8);
+  switch (theOpCode)
+  {
+    case Instruction::OpCode::Add:
+      emit({0x48, 0x01, 0xD0});
+      break;
+
+    case Instruction::OpCode::Sub:
+      emit({0x48, 0x29, 0xD0});
+      break;
+
+    default:
+      emit({0x48, 0x0F, 0xAF, 0xC2});
+      break;
+  }
+}
+
+//**************************************************
+// JitBackend::emitCall
+//**************************************************
+void JitBackend::emitCall(std::size_t theOffset, bool theContext)
+{
+  myAccumulator = NO_SLOT;
+  if (theContext)
+  {
+    // mov (%r12), %rdi
+    emit({0x49, 0x8B, 0x3C, 0x24});
+  }
+  // call *disp8(%r12)
+  emit({0x41, 0xFF, 0x54, 0x24, static_cast<uint8_t>(theOffset)});
+}
+
+//**************************************************
+// JitBackend::emitImmediate
+//**************************************************
+void JitBackend::emitImmediate(int64_t theValue, uint32_t theSize)
+{
+  auto value = static_cast<uint64_t>(theValue);
+  for (uint32_t ii = 0; ii < theSize; ++ii)
+  {
+    myCode.push_back(static_cast<uint8_t>(value >> (8 * ii)));
+  }
+}
+
+//**************************************************
+// JitBackend::emitLoad
+//**************************************************
+void JitBackend::emitLoad(const Operand &theOperand)
+{
+  auto slot = slotOf(theOperand);
+  if (NO_SLOT != slot)
+  {
+    if (slot != myAccumulator)
+    {
+      // mov disp32(%rbx), %rax
+      emit({0x48, 0x8B, 0x83});
+      emitImmediate(8 * slot, 4);
+      myAccumulator = slot;
+    }
+    return;
+  }
+
+  myAccumulator = NO_SLOT;
+  auto value = theOperand.getValue();
+  if (0 == value)
+  {
+    // xor %eax, %eax
+    emit({0x31, 0xC0});
+  }
+  else if (value >= INT32_MIN && value <= INT32_MAX)
+  {
+    // mov $imm32, %rax (sign extended)
+    emit({0x48, 0xC7, 0xC0});
+    emitImmediate(value, 4);
+  }
+  else
+  {
+    // movabs $imm64, %rax
+    emit({0x48, 0xB8});
+    emitImmediate(value, 8);
+  }
+}
+
+//**************************************************
+// JitBackend::emitOverflowCheck
+//**************************************************
+void JitBackend::emitOverflowCheck(uint32_t theLine)
+{
+  // jno +2; ud2
+  emit({0x71, 0x02});
+  myTraps.push_back(myCode.size());
+  myTraps.push_back(theLine);
+  emit({0x0F, 0x0B});
+}
+
+//**************************************************
+// JitBackend::emitStore
+//**************************************************
+void JitBackend::emitStore(const Operand &theOperand)
+{
+  auto slot = slotOf(theOperand);
+  // mov %rax, disp32(%rbx)
+  emit({0x48, 0x89, 0x83});
+  emitImmediate(8 * slot, 4);
+  myAccumulator = slot;
+}
+
+//**************************************************
+// JitBackend::getCode
+//**************************************************
+const std::vector<uint8_t>& JitBackend::getCode() const noexcept
+{
+  return myCode;
+}
+
+//**************************************************
+// JitBackend::getCodeSize
+//**************************************************
+std::size_t JitBackend::getCodeSize() const noexcept
+{
+  return myCode.size();
+}
+
+//**************************************************
+// JitBackend::getFrameSize
+//**************************************************
+uint32_t JitBackend::getFrameSize() const noexcept
+{
+  return myFrameSize;
+}
+
+//**************************************************
+// JitBackend::getRuntimeCallbacks
+//**************************************************
+JitBackend::Callbacks JitBackend::getRuntimeCallbacks() noexcept
+{
+  Callbacks callbacks;
+  callbacks.myContext = nullptr;
+  callbacks.myRead = [](void*) { return micro_read(); };
+  callbacks.myWrite = [](void*, int64_t theValue) { micro_write(theValue); };
+  callbacks.myPower = micro_power;
+  callbacks.myOverflow = micro_overflow;
+  callbacks.myCheckedPower = micro_power_checked;
+  return callbacks;
+}
+
+//**************************************************
+// JitBackend::getTraps
+//**************************************************
+const std::vector<uint32_t>& JitBackend::getTraps() const noexcept
+{
+  return myTraps;
+}
+
+//**************************************************
+// JitBackend::run
+//**************************************************
+void JitBackend::run(const Callbacks &theCallbacks) const
+{
+  run(myMemory->getAddress(), myTraps.data(), myTraps.size() / 2,
+      myFrameSize, theCallbacks);
+}
+
+//**************************************************
+// JitBackend::run
+//**************************************************
+void JitBackend::run(const void *theCode, const uint32_t *theTraps,
+                     uint32_t theTrapCount, uint32_t theFrameSize,
+                     const Callbacks &theCallbacks)
+{
+  using Function = void (*)(int64_t*, const Callbacks*);
+  std::vector<int64_t> frame(theFrameSize, 0);
+  auto function = reinterpret_cast<Function>(const_cast<void*>(theCode));
+  if (0 != theTrapCount)
+  {
+    micro_trap_overflows(theCode, theTraps, theTrapCount,
+                         theCallbacks.myOverflow);
+  }
+  function(frame.data(), &theCallbacks);
+  if (0 != theTrapCount)
+  {
+    micro_trap_overflows(nullptr, nullptr, 0, nullptr);
+  }
+}
+
+//**************************************************
+// JitBackend::slotOf
+//**************************************************
+uint32_t JitBackend::slotOf(const Operand &theOperand) const noexcept
+{
+  switch (theOperand.getKind())
+  {
+    case Operand::Kind::Symbol:
+      return theOperand.getIndex();
+
+    case Operand::Kind::Temporary:
+      return mySymbolCount + theOperand.getIndex();
+
+    default:
+      return NO_SLOT;
+  }
+}
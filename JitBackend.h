@@ -0,0 +1,291 @@
+#ifndef JITBACKEND_H
+#define JITBACKEND_H
+
+/**
+ * @file JitBackend.h
+ * @brief Defines the backend which compiles programs to machine code in
+ *        memory and runs them.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+#include "ExecutableMemory.h"
+#include "Instruction.h"
+
+class Program;
+
+/**
+ * Just in time compiler. Encodes x86-64 machine code for a program straight
+ * into memory (no assembler) and runs it in process as a function:
+ *
+ *   void program(int64_t *frame, const Callbacks *callbacks);
+ *
+ * Every variable has a slot in the frame (symbols, then temporaries), which
+ * starts out zeroed. Read and Write call back to the host, so it decides
+ * where input comes from and output goes.
+ *
+ * Code generation is a single pass over the instructions with no register
+ * allocation, so compiling takes time proportional to the program's size
+ * (microseconds for typical programs). The accumulator (%rax) remembers the
+ * slot it was last loaded from or stored to, so a value just computed isn't
+ * reloaded by the next instruction.
+ *
+ * Checked code (--checked) follows each Add, Sub and Mul with a jno over a
+ * ud2, which traps on overflow. run has the runtime turn a trap into a call
+ * of myOverflow with its line (see getTraps and micro_trap_overflows), so
+ * a check is 4 bytes and there is no code for reporting lines.
+ */
+class JitBackend
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Host routines called by compiled code. Must be standard layout (the
+   * generated code calls through it at fixed offsets).
+   */
+  struct Callbacks
+  {
+    /** Passed to myRead and myWrite. */
+    void *myContext;
+
+    /** Implements Read, returning the integer read. */
+    int64_t (*myRead)(void *theContext);
+
+    /** Implements Write. */
+    void (*myWrite)(void *theContext, int64_t theValue);
+
+    /** Implements Pow. */
+    int64_t (*myPower)(int64_t theBase, int64_t theExponent);
+
+    /**
+     * Reports a signed overflow on a line of checked code (resumed in from
+     * a trap, see run); doesn't return.
+     */
+    void (*myOverflow)(uint32_t theLine);
+
+    /** Implements checked Pow (calling myOverflow on overflow). */
+    int64_t (*myCheckedPower)(int64_t theBase, int64_t theExponent,
+                              uint32_t theLine);
+  };
+
+  /**
+   * Default constructor.
+   */
+  JitBackend() = default;
+
+  /**
+   * Copy constructor
+   */
+  JitBackend(const JitBackend &) = delete;
+
+  /**
+   * Move constructor
+   */
+  JitBackend(JitBackend &&) = delete;
+
+  /**
+   * Destructor
+   */
+  ~JitBackend() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  JitBackend& operator=(const JitBackend &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  JitBackend& operator=(JitBackend &&) = delete;
+
+  /**
+   * Compiles a program, replacing any compiled before.
+   *
+   * @param theProgram
+   *          program to compile
+   * @param theChecked
+   *          stop on signed overflow (rather than wrap)?
+   * @throws std::runtime_error
+   *           if the code can't be mapped for execution
+   */
+  void compile(const Program &theProgram, bool theChecked);
+
+  /**
+   * Returns the machine code generated. It is position independent: it
+   * only refers to the frame and callbacks it is passed.
+   *
+   * @return code
+   */
+  const std::vector<uint8_t>& getCode() const noexcept;
+
+  /**
+   * Returns the number of bytes of machine code generated.
+   *
+   * @return code size
+   */
+  std::size_t getCodeSize() const noexcept;
+
+  /**
+   * Returns the number of slots in the frame.
+   *
+   * @return frame size, in 64 bit slots
+   */
+  uint32_t getFrameSize() const noexcept;
+
+  /**
+   * Returns callbacks implementing Read and Write on stdin and stdout
+   * (with the runtime library, see Runtime.h).
+   *
+   * @return callbacks
+   */
+  static Callbacks getRuntimeCallbacks() noexcept;
+
+  /**
+   * Returns the overflow traps of checked code.
+   *
+   * @return pairs of a ud2's offset in the code and its source line, in
+   *         order of offset
+   */
+  const std::vector<uint32_t>& getTraps() const noexcept;
+
+  /**
+   * Runs the compiled program once, with a fresh frame.
+   *
+   * @param theCallbacks
+   *          host routines
+   */
+  void run(const Callbacks &theCallbacks) const;
+
+  /**
+   * Runs code compiled earlier (e.g., as mapped from an ObjectFile) once,
+   * with a fresh frame.
+   *
+   * @param theCode
+   *          executable code
+   * @param theTraps
+   *          its overflow traps (see getTraps)
+   * @param theTrapCount
+   *          number of traps
+   * @param theFrameSize
+   *          number of slots in the frame
+   * @param theCallbacks
+   *          host routines
+   */
+  static void run(const void *theCode, const uint32_t *theTraps,
+                  uint32_t theTrapCount, uint32_t theFrameSize,
+                  const Callbacks &theCallbacks);
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Slot number of nothing (e.g., a literal). */
+  static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+  /**
+   * Appends bytes of code.
+   *
+   * @param theBytes
+   *          bytes
+   */
+  void emit(std::initializer_list<uint8_t> theBytes);
+
+  /**
+   * Appends a little endian integer.
+   *
+   * @param theValue
+   *          value
+   * @param theSize
+   *          size in bytes (4 or 8)
+   */
+  void emitImmediate(int64_t theValue, uint32_t theSize);
+
+  /**
+   * Appends code applying an operation to %rax and an operand, leaving the
+   * result in %rax.
+   *
+   * @param theOpCode
+   *          Add, Sub or Mul
+   * @param theOperand
+   *          right operand
+   */
+  void emitArithmetic(Instruction::OpCode theOpCode,
+                      const Operand &theOperand);
+
+  /**
+   * Appends a call through the callbacks (held in %r12).
+   *
+   * @param theOffset
+   *          offset of the callback in Callbacks
+   * @param theContext
+   *          pass the context as the first argument?
+   */
+  void emitCall(std::size_t theOffset, bool theContext);
+
+  /**
+   * Appends a trap taken on overflow (see getTraps).
+   *
+   * @param theLine
+   *          source line
+   */
+  void emitOverflowCheck(uint32_t theLine);
+
+  /**
+   * Appends code to load an operand into %rax.
+   *
+   * @param theOperand
+   *          literal or variable
+   */
+  void emitLoad(const Operand &theOperand);
+
+  /**
+   * Appends code to store %rax into a variable.
+   *
+   * @param theOperand
+   *          variable
+   */
+  void emitStore(const Operand &theOperand);
+
+  /**
+   * Returns the frame slot of a variable.
+   *
+   * @param theOperand
+   *          operand
+   * @return slot, or NO_SLOT for a literal
+   */
+  uint32_t slotOf(const Operand &theOperand) const noexcept;
+
+  /** Slot %rax holds the value of, or NO_SLOT. */
+  uint32_t myAccumulator = NO_SLOT;
+
+  /** Code being generated. */
+  std::vector<uint8_t> myCode;
+
+  /** Number of slots in the frame. */
+  uint32_t myFrameSize = 0;
+
+  /** Compiled code. */
+  std::unique_ptr<ExecutableMemory> myMemory;
+
+  /** Overflow traps (see getTraps). */
+  std::vector<uint32_t> myTraps;
+
+  /** Number of symbols in the program (temporaries' slots follow). */
+  uint32_t mySymbolCount = 0;
+};
+
+#endif
@@ -0,0 +1,247 @@
+/**
+ * @file LinearScanAllocator.cpp
+ * @brief Implementation of LinearScanAllocator class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+
+#include "Instruction.h"
+#include "LinearScanAllocator.h"
+#include "Program.h"
+#include "SSAForm.h"
+
+//**************************************************
+// LinearScanAllocator::LinearScanAllocator
+//**************************************************
+LinearScanAllocator::LinearScanAllocator(uint32_t theScratchCount,
+                                         uint32_t thePreservedCount) :
+  myPreservedCount(thePreservedCount),
+  myScratchCount(theScratchCount)
+{
+}
+
+//**************************************************
+// LinearScanAllocator::allocate
+//**************************************************
+void LinearScanAllocator::allocate(
+  const Program &theProgram, const SSAForm &theSSA,
+  const std::function<bool(const Instruction&)> &theIsCall)
+{
+  auto &instructions = theProgram.getInstructions();
+  const uint32_t registerCount = myScratchCount + myPreservedCount;
+  myFree.assign(registerCount, true);
+  myUsed.assign(registerCount, false);
+  myLocations.assign(theSSA.getValueCount(),
+                     Location{Location::Kind::None, 0});
+  mySpillCount = 0;
+
+  // Number of calls before each instruction, to find intervals live across
+  // one.
+  std::vector<uint32_t> callsBefore(instructions.size() + 1, 0);
+  for (std::size_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    callsBefore[ii + 1] = callsBefore[ii] +
+      (theIsCall(instructions[ii]) ? 1 : 0);
+  }
+
+  // Values are numbered in order of definition, so intervals come out
+  // sorted by start. Entry values are never assigned, so need no location.
+  std::vector<Interval> intervals;
+  for (uint32_t value = 0; value < theSSA.getValueCount(); ++value)
+  {
+    if (SSAForm::Kind::Instruction != theSSA.getKind(value))
+    {
+      continue;
+    }
+    auto start = theSSA.getInstruction(value);
+    auto uses = theSSA.getUseCount(value);
+    auto end = (0 == uses) ? start :
+      theSSA.getUse(value, uses - 1).myInstruction;
+    intervals.push_back(Interval{value, start, end});
+  }
+
+  // Intervals holding a register, and those spilled.
+  std::vector<Interval> active;
+  std::vector<Interval> spilled;
+  std::vector<uint32_t> hints;
+  for (auto &interval : intervals)
+  {
+    // Sources are read before the destination is written, so an interval
+    // ending where this one starts no longer needs its register.
+    auto expired = std::remove_if(
+      active.begin(), active.end(), [&](const Interval &theActive)
+      {
+        if (theActive.myEnd > interval.myStart)
+        {
+          return false;
+        }
+        myFree[myLocations[theActive.myValue].myIndex] = true;
+        return true;
+      });
+    active.erase(expired, active.end());
+
+    auto &instruction = instructions[interval.myStart];
+    hints.clear();
+    for (uint32_t source = 0; source < instruction.getSourceCount();
+         ++source)
+    {
+      // The subtrahend can't share the difference's register.
+      if (Instruction::OpCode::Sub == instruction.getOpCode() && 1 == source)
+      {
+        continue;
+      }
+      auto value = theSSA.getValue(interval.myStart, source);
+      if (SSAForm::NO_VALUE != value &&
+          Location::Kind::Register == myLocations[value].myKind)
+      {
+        hints.push_back(myLocations[value].myIndex);
+      }
+    }
+
+    bool crossesCall = (interval.myEnd > interval.myStart &&
+                        callsBefore[interval.myEnd] >
+                        callsBefore[interval.myStart + 1]);
+    auto reg = takeRegister(crossesCall, hints);
+    if (UINT32_MAX == reg)
+    {
+      // Spill whichever interval, this or an active one holding a suitable
+      // register, is live the longest.
+      auto victim = active.end();
+      for (auto candidate = active.begin(); candidate != active.end();
+           ++candidate)
+      {
+        if ((! crossesCall ||
+             myLocations[candidate->myValue].myIndex >= myScratchCount) &&
+            (active.end() == victim || candidate->myEnd > victim->myEnd))
+        {
+          victim = candidate;
+        }
+      }
+
+      if (active.end() != victim && victim->myEnd > interval.myEnd)
+      {
+        reg = myLocations[victim->myValue].myIndex;
+        spilled.push_back(*victim);
+        active.erase(victim);
+      }
+      else
+      {
+        spilled.push_back(interval);
+        continue;
+      }
+    }
+
+    myLocations[interval.myValue] = Location{Location::Kind::Register, reg};
+    myUsed[reg] = true;
+    active.push_back(interval);
+  }
+
+  std::sort(spilled.begin(), spilled.end(),
+            [](const Interval &theLeft, const Interval &theRight)
+            {
+              return theLeft.myStart < theRight.myStart;
+            });
+  assignStackSlots(spilled);
+}
+
+//**************************************************
+// LinearScanAllocator::assignStackSlots
+//**************************************************
+void LinearScanAllocator::assignStackSlots(
+  const std::vector<Interval> &theSpilled)
+{
+  mySpillCount = theSpilled.size();
+  myStackSlotCount = 0;
+
+  std::vector<Interval> active;
+  std::vector<uint32_t> freeSlots;
+  for (auto &interval : theSpilled)
+  {
+    auto expired = std::remove_if(
+      active.begin(), active.end(), [&](const Interval &theActive)
+      {
+        if (theActive.myEnd > interval.myStart)
+        {
+          return false;
+        }
+        freeSlots.push_back(myLocations[theActive.myValue].myIndex);
+        return true;
+      });
+    active.erase(expired, active.end());
+
+    uint32_t slot;
+    if (freeSlots.empty())
+    {
+      slot = myStackSlotCount++;
+    }
+    else
+    {
+      slot = freeSlots.back();
+      freeSlots.pop_back();
+    }
+    myLocations[interval.myValue] = Location{Location::Kind::Stack, slot};
+    active.push_back(interval);
+  }
+}
+
+//**************************************************
+// LinearScanAllocator::getLocation
+//**************************************************
+const LinearScanAllocator::Location& LinearScanAllocator::getLocation(
+  uint32_t theValue) const noexcept
+{
+  return myLocations[theValue];
+}
+
+//**************************************************
+// LinearScanAllocator::getSpillCount
+//**************************************************
+uint32_t LinearScanAllocator::getSpillCount() const noexcept
+{
+  return mySpillCount;
+}
+
+//**************************************************
+// LinearScanAllocator::getStackSlotCount
+//**************************************************
+uint32_t LinearScanAllocator::getStackSlotCount() const noexcept
+{
+  return myStackSlotCount;
+}
+
+//**************************************************
+// LinearScanAllocator::isUsed
+//**************************************************
+bool LinearScanAllocator::isUsed(uint32_t theRegister) const noexcept
+{
+  return myUsed[theRegister];
+}
+
+//**************************************************
+// LinearScanAllocator::takeRegister
+//**************************************************
+uint32_t LinearScanAllocator::takeRegister(
+  bool theCrossesCall, const std::vector<uint32_t> &theHints) noexcept
+{
+  const uint32_t first = theCrossesCall ? myScratchCount : 0;
+  const uint32_t registerCount = myScratchCount + myPreservedCount;
+  for (auto hint : theHints)
+  {
+    if (hint >= first && myFree[hint])
+    {
+      myFree[hint] = false;
+      return hint;
+    }
+  }
+  for (uint32_t reg = first; reg < registerCount; ++reg)
+  {
+    if (myFree[reg])
+    {
+      myFree[reg] = false;
+      return reg;
+    }
+  }
+  return UINT32_MAX;
+}
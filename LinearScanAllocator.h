@@ -0,0 +1,215 @@
+#ifndef LINEARSCANALLOCATOR_H
+#define LINEARSCANALLOCATOR_H
+
+/**
+ * @file LinearScanAllocator.h
+ * @brief Defines the linear scan register allocator used by native backends.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Instruction;
+class Program;
+class SSAForm;
+
+/**
+ * Linear scan register allocation (Poletto and Sarkar) over the values of
+ * a program's SSA form. Each value is live from the instruction defining it
+ * to its last use; the program is straight-line code, so that is a single
+ * interval. Intervals are visited in order of their start, and one is given
+ * a register if one is free, otherwise the active interval ending last is
+ * spilled to a stack slot for its whole life.
+ *
+ * Registers are numbered by the backend: the first theScratchCount are
+ * clobbered by calls, the rest are preserved across them. An interval live
+ * across a call may only be given a preserved register; any other prefers
+ * a scratch register, leaving the preserved ones (which must be saved and
+ * restored by the function) for values which need them. An interval also
+ * prefers the register of a source operand dying where it is defined, so
+ * most copies become no-ops.
+ *
+ * Stack slots are assigned once all spills are known, reusing the slot of
+ * any spilled interval which has ended.
+ */
+class LinearScanAllocator
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** Where a value is kept. */
+  struct Location
+  {
+    /** Kinds of location. */
+    enum class Kind : uint8_t
+    {
+      None,
+      Register,
+      Stack
+    };
+
+    /** Kind of location (None for entry values, which are always 0). */
+    Kind myKind;
+
+    /** Register number or stack slot. */
+    uint32_t myIndex;
+  };
+
+  /**
+   * Default constructor.
+   */
+  LinearScanAllocator() = delete;
+
+  /**
+   * Constructor.
+   *
+   * @param theScratchCount
+   *          number of registers clobbered by calls
+   * @param thePreservedCount
+   *          number of registers preserved across calls
+   */
+  LinearScanAllocator(uint32_t theScratchCount, uint32_t thePreservedCount);
+
+  /**
+   * Copy constructor
+   */
+  LinearScanAllocator(const LinearScanAllocator &) = default;
+
+  /**
+   * Move constructor
+   */
+  LinearScanAllocator(LinearScanAllocator &&) = default;
+
+  /**
+   * Destructor
+   */
+  ~LinearScanAllocator() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  LinearScanAllocator& operator=(const LinearScanAllocator &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  LinearScanAllocator& operator=(LinearScanAllocator &&) = default;
+
+  /**
+   * Allocates every value of a program.
+   *
+   * @param theProgram
+   *          program
+   * @param theSSA
+   *          SSA form of the program
+   * @param theIsCall
+   *          returns if an instruction is implemented by a call (clobbering
+   *          the scratch registers)
+   */
+  void allocate(const Program &theProgram, const SSAForm &theSSA,
+                const std::function<bool(const Instruction&)> &theIsCall);
+
+  /**
+   * Returns where a value is kept.
+   *
+   * @param theValue
+   *          SSA value number
+   * @return location
+   */
+  const Location& getLocation(uint32_t theValue) const noexcept;
+
+  /**
+   * Returns the number of values spilled to the stack.
+   *
+   * @return number of spilled values
+   */
+  uint32_t getSpillCount() const noexcept;
+
+  /**
+   * Returns the number of stack slots needed.
+   *
+   * @return number of stack slots
+   */
+  uint32_t getStackSlotCount() const noexcept;
+
+  /**
+   * Returns if a register was given to any value.
+   *
+   * @param theRegister
+   *          register number
+   * @return true if used
+   */
+  bool isUsed(uint32_t theRegister) const noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** A live interval. */
+  struct Interval
+  {
+    /** SSA value number. */
+    uint32_t myValue;
+
+    /** Index of the defining instruction. */
+    uint32_t myStart;
+
+    /** Index of the last instruction using the value. */
+    uint32_t myEnd;
+  };
+
+  /**
+   * Takes a free register, from the preserved ones only if the interval
+   * crosses a call.
+   *
+   * @param theCrossesCall
+   *          is the interval live across a call?
+   * @param theHints
+   *          registers preferred, most preferred first
+   * @return register number, or UINT32_MAX if none is free
+   */
+  uint32_t takeRegister(bool theCrossesCall,
+                        const std::vector<uint32_t> &theHints) noexcept;
+
+  /**
+   * Assigns stack slots to the spilled intervals.
+   *
+   * @param theSpilled
+   *          spilled intervals, in order of start
+   */
+  void assignStackSlots(const std::vector<Interval> &theSpilled);
+
+  /** Is each register free? */
+  std::vector<bool> myFree;
+
+  /** Location of each value. */
+  std::vector<Location> myLocations;
+
+  /** Number of preserved registers. */
+  uint32_t myPreservedCount;
+
+  /** Number of scratch registers. */
+  uint32_t myScratchCount;
+
+  /** Number of values spilled. */
+  uint32_t mySpillCount = 0;
+
+  /** Number of stack slots. */
+  uint32_t myStackSlotCount = 0;
+
+  /** Was each register given to any value? */
+  std::vector<bool> myUsed;
+};
+
+#endif
@@ -0,0 +1,32 @@
+/**
+ * @file MemorySink.cpp
+ * @brief Implementation of MemorySink class
+ *
+ * @author Michael Albers
+ */
+
+#include "MemorySink.h"
+
+//**************************************************
+// MemorySink::flush
+//**************************************************
+void MemorySink::flush()
+{
+  // Nothing to do, output is never buffered.
+}
+
+//**************************************************
+// MemorySink::getContents
+//**************************************************
+const std::string& MemorySink::getContents() const noexcept
+{
+  return myContents;
+}
+
+//**************************************************
+// MemorySink::write
+//**************************************************
+void MemorySink::write(const char *theData, std::size_t theLength) noexcept
+{
+  myContents.append(theData, theLength);
+}
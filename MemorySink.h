@@ -0,0 +1,63 @@
+#ifndef MEMORYSINK_H
+#define MEMORYSINK_H
+
+/**
+ * @file MemorySink.h
+ * @brief Defines a sink which keeps all output in memory.
+ *
+ * @author Michael Albers
+ */
+
+#include <string>
+
+#include "OutputSink.h"
+
+/**
+ * Sink which accumulates all output in memory.
+ */
+class MemorySink : public OutputSink
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  MemorySink() = default;
+
+  /**
+   * Destructor
+   */
+  virtual ~MemorySink() = default;
+
+  virtual void flush() override;
+
+  /**
+   * Returns everything written so far.
+   *
+   * @return all output
+   */
+  const std::string& getContents() const noexcept;
+
+  using OutputSink::write;
+
+  virtual void write(const char *theData, std::size_t theLength)
+    noexcept override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** All output. */
+  std::string myContents;
+};
+
+#endif
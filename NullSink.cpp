@@ -0,0 +1,22 @@
+/**
+ * @file NullSink.cpp
+ * @brief Implementation of NullSink class
+ *
+ * @author Michael Albers
+ */
+
+#include "NullSink.h"
+
+//**************************************************
+// NullSink::flush
+//**************************************************
+void NullSink::flush()
+{
+}
+
+//**************************************************
+// NullSink::write
+//**************************************************
+void NullSink::write(const char *, std::size_t) noexcept
+{
+}
@@ -0,0 +1,51 @@
+#ifndef NULLSINK_H
+#define NULLSINK_H
+
+/**
+ * @file NullSink.h
+ * @brief Defines a sink which discards all output.
+ *
+ * @author Michael Albers
+ */
+
+#include "OutputSink.h"
+
+/**
+ * Sink which discards all output (e.g., when only diagnostics are wanted).
+ */
+class NullSink : public OutputSink
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  NullSink() = default;
+
+  /**
+   * Destructor
+   */
+  virtual ~NullSink() = default;
+
+  virtual void flush() override;
+
+  using OutputSink::write;
+
+  virtual void write(const char *theData, std::size_t theLength)
+    noexcept override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+};
+
+#endif
@@ -0,0 +1,407 @@
+/**
+ * @file ObjectFile.cpp
+ * @brief Implementation of ObjectFile class
+ *
+ * @author Michael Albers
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "FileDescriptorSink.h"
+#include "ObjectFile.h"
+#include "Program.h"
+
+const char ObjectFile::MAGIC[8] = {'M', 'I', 'C', 'R', 'O', 'O', 'B', 'J'};
+
+constexpr uint32_t ObjectFile::VERSION;
+constexpr uint32_t ObjectFile::BYTE_ORDER_MARK;
+constexpr uint64_t ObjectFile::NATIVE_ALIGNMENT;
+
+//**************************************************
+// ObjectFile::ObjectFile
+//**************************************************
+ObjectFile::ObjectFile(const std::string &theFile)
+{
+  int fd = ::open(theFile.c_str(), O_RDONLY);
+  struct stat status;
+  if (fd < 0 || 0 != ::fstat(fd, &status))
+  {
+    auto localErrno = errno;
+    if (fd >= 0)
+    {
+      ::close(fd);
+    }
+    throw std::runtime_error("Failed to open '" + theFile + "': " +
+                             std::strerror(localErrno));
+  }
+
+  mySize = status.st_size;
+  void *address = (0 == mySize) ? MAP_FAILED :
+    ::mmap(nullptr, mySize, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (MAP_FAILED == address)
+  {
+    auto localErrno = errno;
+    ::close(fd);
+    throw std::runtime_error("Failed to map '" + theFile + "': " +
+                             std::strerror(0 == mySize ? EINVAL : localErrno));
+  }
+  myAddress = static_cast<const uint8_t*>(address);
+
+  auto problem = check(mySize);
+  if (problem.empty() && 0 != getHeader().myNativeSize)
+  {
+    // Mapped straight from the file, read-only and executable. Where that
+    // isn't allowed (e.g., a noexec mount) there is just no native code.
+    myNativeSize = getHeader().myNativeSize;
+    myNativeCode = ::mmap(nullptr, myNativeSize, PROT_READ | PROT_EXEC,
+                          MAP_PRIVATE, fd, getHeader().myNativeOffset);
+    if (MAP_FAILED == myNativeCode)
+    {
+      myNativeCode = nullptr;
+    }
+  }
+  ::close(fd);
+
+  if (! problem.empty())
+  {
+    unmap();
+    throw std::runtime_error("'" + theFile + "' isn't a valid object file: " +
+                             problem + ".");
+  }
+}
+
+//**************************************************
+// ObjectFile::~ObjectFile
+//**************************************************
+ObjectFile::~ObjectFile()
+{
+  unmap();
+}
+
+//**************************************************
+// ObjectFile::unmap
+//**************************************************
+void ObjectFile::unmap() noexcept
+{
+  if (nullptr != myNativeCode)
+  {
+    ::munmap(myNativeCode, myNativeSize);
+    myNativeCode = nullptr;
+  }
+  if (nullptr != myAddress)
+  {
+    ::munmap(const_cast<uint8_t*>(myAddress), mySize);
+    myAddress = nullptr;
+  }
+}
+
+//**************************************************
+// ObjectFile::check
+//**************************************************
+std::string ObjectFile::check(std::size_t theFileSize) const
+{
+  if (theFileSize < sizeof(Header))
+  {
+    return "too short";
+  }
+  auto &header = getHeader();
+  if (0 != std::memcmp(header.myMagic, MAGIC, sizeof(MAGIC)))
+  {
+    return "bad magic number";
+  }
+  if (BYTE_ORDER_MARK != header.myByteOrder)
+  {
+    return "written on a machine of the other byte order";
+  }
+  if (VERSION != header.myVersion)
+  {
+    return "version " + std::to_string(header.myVersion) + " (expected " +
+      std::to_string(VERSION) + ")";
+  }
+  if (theFileSize != header.myFileSize)
+  {
+    return "truncated";
+  }
+
+  auto fits = [&](uint64_t theOffset, uint64_t theSize, uint64_t theAlignment)
+  {
+    return 0 == theOffset % theAlignment && theOffset <= theFileSize &&
+      theSize <= theFileSize - theOffset;
+  };
+  if (! fits(header.myConstantOffset,
+             sizeof(int64_t) * uint64_t(header.myConstantCount),
+             alignof(int64_t)) ||
+      ! fits(header.mySymbolOffset, header.mySymbolSize, 1) ||
+      ! fits(header.mySourceOffset, header.mySourceSize, 1) ||
+      ! fits(header.myOperationOffset,
+             sizeof(Bytecode::Operation) * uint64_t(header.myOperationCount),
+             alignof(Bytecode::Operation)) ||
+      ! fits(header.myLineOffset,
+             sizeof(uint32_t) * uint64_t(header.myOperationCount),
+             alignof(uint32_t)) ||
+      ! fits(header.myTrapOffset,
+             2 * sizeof(uint32_t) * uint64_t(header.myTrapCount),
+             alignof(uint32_t)) ||
+      ! fits(header.myNativeOffset, header.myNativeSize, NATIVE_ALIGNMENT))
+  {
+    return "a section is outside the file";
+  }
+  if (header.mySymbolCount > header.myConstantBase ||
+      uint64_t(header.myConstantBase) + header.myConstantCount !=
+        header.myFrameSize)
+  {
+    return "bad frame layout";
+  }
+
+  // Operations can't touch memory outside the frame.
+  auto operations = getOperations();
+  auto count = header.myOperationCount;
+  if (0 == count || Bytecode::OpCode::Halt != operations[count - 1].myOpCode)
+  {
+    return "bytecode doesn't end with Halt";
+  }
+  for (uint32_t ii = 0; ii < count; ++ii)
+  {
+    auto &operation = operations[ii];
+    auto opCode = static_cast<uint32_t>(operation.myOpCode);
+    if (opCode >= Bytecode::OPCODE_COUNT)
+    {
+      return "bad operation " + std::to_string(ii);
+    }
+    // (The second operand of ReadN and WriteN is a count.)
+    auto isCount = (Bytecode::OpCode::ReadN == operation.myOpCode ||
+                    Bytecode::OpCode::WriteN == operation.myOpCode);
+    for (uint32_t jj = 0; jj < 3; ++jj)
+    {
+      if (operation.myOperands[jj] >= header.myFrameSize &&
+          ! (isCount && 1 == jj))
+      {
+        return "operation " + std::to_string(ii) + " is outside the frame";
+      }
+    }
+
+    // Superinstructions read operands from the operations they cover.
+    uint64_t covered = 1;
+    switch (operation.myOpCode)
+    {
+      case Bytecode::OpCode::ReadN:
+      case Bytecode::OpCode::WriteN:
+        covered = operation.myOperands[1];
+        break;
+
+      case Bytecode::OpCode::AddMove:
+      case Bytecode::OpCode::SubMove:
+      case Bytecode::OpCode::AddWrite:
+      case Bytecode::OpCode::SubWrite:
+        covered = 2;
+        break;
+
+      default:
+        break;
+    }
+    if (0 == covered || (covered > 1 && ii + covered >= count))
+    {
+      return "operation " + std::to_string(ii) + " runs past the end";
+    }
+  }
+  return "";
+}
+
+//**************************************************
+// ObjectFile::getConstants
+//**************************************************
+const int64_t* ObjectFile::getConstants() const noexcept
+{
+  return reinterpret_cast<const int64_t*>(
+    myAddress + getHeader().myConstantOffset);
+}
+
+//**************************************************
+// ObjectFile::getHeader
+//**************************************************
+const ObjectFile::Header& ObjectFile::getHeader() const noexcept
+{
+  return *reinterpret_cast<const Header*>(myAddress);
+}
+
+//**************************************************
+// ObjectFile::getLines
+//**************************************************
+const uint32_t* ObjectFile::getLines() const noexcept
+{
+  return reinterpret_cast<const uint32_t*>(
+    myAddress + getHeader().myLineOffset);
+}
+
+//**************************************************
+// ObjectFile::getNativeCode
+//**************************************************
+const void* ObjectFile::getNativeCode() const noexcept
+{
+  return myNativeCode;
+}
+
+//**************************************************
+// ObjectFile::getOperations
+//**************************************************
+const Bytecode::Operation* ObjectFile::getOperations() const noexcept
+{
+  return reinterpret_cast<const Bytecode::Operation*>(
+    myAddress + getHeader().myOperationOffset);
+}
+
+//**************************************************
+// ObjectFile::getSource
+//**************************************************
+std::string ObjectFile::getSource() const
+{
+  return std::string(
+    reinterpret_cast<const char*>(myAddress + getHeader().mySourceOffset),
+    getHeader().mySourceSize);
+}
+
+//**************************************************
+// ObjectFile::getTraps
+//**************************************************
+const uint32_t* ObjectFile::getTraps() const noexcept
+{
+  return reinterpret_cast<const uint32_t*>(
+    myAddress + getHeader().myTrapOffset);
+}
+
+//**************************************************
+// ObjectFile::hash
+//**************************************************
+uint64_t ObjectFile::hash(const std::string &theFile)
+{
+  std::ifstream file(theFile, std::ios::binary);
+  if (! file)
+  {
+    throw std::runtime_error("Failed to open '" + theFile + "'.");
+  }
+
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (std::istreambuf_iterator<char> ii(file), end; ii != end; ++ii)
+  {
+    hash = (hash ^ static_cast<unsigned char>(*ii)) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+//**************************************************
+// ObjectFile::isObject
+//**************************************************
+bool ObjectFile::isObject(const std::string &theFile) noexcept
+{
+  std::ifstream file(theFile, std::ios::binary);
+  char magic[sizeof(MAGIC)];
+  return file.read(magic, sizeof(magic)) &&
+    0 == std::memcmp(magic, MAGIC, sizeof(MAGIC));
+}
+
+//**************************************************
+// ObjectFile::isOutOfDate
+//**************************************************
+bool ObjectFile::isOutOfDate() const noexcept
+{
+  try
+  {
+    return hash(getSource()) != getHeader().mySourceHash;
+  }
+  catch (...)
+  {
+    return false;
+  }
+}
+
+//**************************************************
+// ObjectFile::write
+//**************************************************
+void ObjectFile::write(const std::string &theFile, const Program &theProgram,
+                       const Bytecode &theBytecode,
+                       const std::vector<uint8_t> &theNativeCode,
+                       const std::vector<uint32_t> &theTraps,
+                       const std::string &theSource)
+{
+  auto &constants = theBytecode.getConstants();
+  auto &lines = theBytecode.getLines();
+  auto &operations = theBytecode.getOperations();
+  auto &symbols = theProgram.getSymbolTable();
+
+  std::string symbolTable;
+  for (uint32_t ii = 0; ii < symbols.size(); ++ii)
+  {
+    symbolTable += symbols.getSymbol(ii);
+    symbolTable.push_back('\0');
+  }
+
+  auto align = [](uint64_t theOffset, uint64_t theAlignment)
+  {
+    return (theOffset + theAlignment - 1) / theAlignment * theAlignment;
+  };
+
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.myMagic, MAGIC, sizeof(MAGIC));
+  header.myVersion = VERSION;
+  header.myByteOrder = BYTE_ORDER_MARK;
+  header.mySourceHash = hash(theSource);
+  header.myFrameSize = theBytecode.getFrameSize();
+  header.myConstantBase = theBytecode.getConstantBase();
+  header.myConstantCount = constants.size();
+  header.mySymbolCount = symbols.size();
+  header.myOperationCount = operations.size();
+  header.myTrapCount = theTraps.size() / 2;
+  header.myConstantOffset = align(sizeof(Header), alignof(int64_t));
+  header.mySymbolOffset =
+    header.myConstantOffset + sizeof(int64_t) * constants.size();
+  header.mySymbolSize = symbolTable.size();
+  header.mySourceOffset = header.mySymbolOffset + symbolTable.size();
+  header.mySourceSize = theSource.size();
+  header.myOperationOffset = align(header.mySourceOffset + theSource.size(),
+                                   alignof(Bytecode::Operation));
+  header.myLineOffset =
+    header.myOperationOffset + sizeof(Bytecode::Operation) * operations.size();
+  header.myTrapOffset = header.myLineOffset + sizeof(uint32_t) * lines.size();
+  header.myFileSize = header.myTrapOffset + sizeof(uint32_t) * theTraps.size();
+  if (! theNativeCode.empty())
+  {
+    header.myNativeOffset = align(header.myFileSize, NATIVE_ALIGNMENT);
+    header.myNativeSize = theNativeCode.size();
+    header.myFileSize = header.myNativeOffset + header.myNativeSize;
+  }
+
+  std::string image(header.myFileSize, '\0');
+  // (An empty section's data() may be null, which memcpy doesn't allow.)
+  auto copy = [&](uint64_t theOffset, const void *theData, std::size_t theSize)
+  {
+    if (0 != theSize)
+    {
+      std::memcpy(&image[theOffset], theData, theSize);
+    }
+  };
+  copy(0, &header, sizeof(header));
+  copy(header.myConstantOffset, constants.data(),
+       sizeof(int64_t) * constants.size());
+  copy(header.mySymbolOffset, symbolTable.data(), symbolTable.size());
+  copy(header.mySourceOffset, theSource.data(), theSource.size());
+  copy(header.myOperationOffset, operations.data(),
+       sizeof(Bytecode::Operation) * operations.size());
+  copy(header.myLineOffset, lines.data(), sizeof(uint32_t) * lines.size());
+  copy(header.myTrapOffset, theTraps.data(),
+       sizeof(uint32_t) * theTraps.size());
+  copy(header.myNativeOffset, theNativeCode.data(), theNativeCode.size());
+
+  FileDescriptorSink sink(theFile);
+  sink.write(image);
+  sink.flush();
+}
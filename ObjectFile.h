@@ -0,0 +1,306 @@
+#ifndef OBJECTFILE_H
+#define OBJECTFILE_H
+
+/**
+ * @file ObjectFile.h
+ * @brief Defines the compiled program file format.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Bytecode.h"
+
+class Program;
+
+/**
+ * A compiled program, saved so it can be run again without compiling. The
+ * file is laid out so it can be mapped and run in place: after checking
+ * the header and that every operation stays within the frame, nothing is
+ * parsed, copied or relocated.
+ *
+ *   Header
+ *   constant pool    int64_t[myConstantCount], 8 byte aligned
+ *   symbol table     symbol names, each NUL terminated, in slot order
+ *   source name      name of the source file, as it was compiled
+ *   bytecode         Bytecode::Operation[myOperationCount], 4 byte aligned
+ *   source lines     uint32_t[myOperationCount], one per operation
+ *   overflow traps   uint32_t[2 * myTrapCount], of the native code (see
+ *                    JitBackend::getTraps)
+ *   native code      optional JIT code (see JitBackend), page aligned
+ *
+ * Integers are in the byte order of the machine that wrote the file, which
+ * must be the one that runs it. The source's name and hash tell when an
+ * object file is out of date (see isOutOfDate).
+ */
+class ObjectFile
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** Start of the file. */
+  struct Header
+  {
+    /** MAGIC. */
+    char myMagic[8];
+
+    /** VERSION. */
+    uint32_t myVersion;
+
+    /** BYTE_ORDER_MARK, as written. */
+    uint32_t myByteOrder;
+
+    /** FNV-1a hash of the source file (see hash). */
+    uint64_t mySourceHash;
+
+    /** Size of the whole file. */
+    uint64_t myFileSize;
+
+    /** Number of frame slots (variables, then constants). */
+    uint32_t myFrameSize;
+
+    /** Frame slot of the first constant (the number of variables). */
+    uint32_t myConstantBase;
+
+    /** Number of constants. */
+    uint32_t myConstantCount;
+
+    /** Number of symbols. */
+    uint32_t mySymbolCount;
+
+    /** Number of operations. */
+    uint32_t myOperationCount;
+
+    /** Number of overflow traps in the native code. */
+    uint32_t myTrapCount;
+
+    /** File offset of the constant pool. */
+    uint64_t myConstantOffset;
+
+    /** File offset of the symbol table. */
+    uint64_t mySymbolOffset;
+
+    /** Size of the symbol table. */
+    uint64_t mySymbolSize;
+
+    /** File offset of the source name. */
+    uint64_t mySourceOffset;
+
+    /** Size of the source name. */
+    uint64_t mySourceSize;
+
+    /** File offset of the bytecode. */
+    uint64_t myOperationOffset;
+
+    /** File offset of the source lines. */
+    uint64_t myLineOffset;
+
+    /** File offset of the overflow traps. */
+    uint64_t myTrapOffset;
+
+    /** File offset of the native code (0 if none). */
+    uint64_t myNativeOffset;
+
+    /** Size of the native code (0 if none). */
+    uint64_t myNativeSize;
+  };
+
+  /** Identifies an object file. */
+  static const char MAGIC[8];
+
+  /** Format version. */
+  static constexpr uint32_t VERSION = 4;
+
+  /** Reads differently on a machine of the other byte order. */
+  static constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  /** Alignment of the native code in the file. */
+  static constexpr uint64_t NATIVE_ALIGNMENT = 4096;
+
+  /**
+   * Default constructor.
+   */
+  ObjectFile() = delete;
+
+  /**
+   * Constructor. Maps an object file and checks it.
+   *
+   * @param theFile
+   *          object file
+   * @throws std::runtime_error
+   *           if the file can't be mapped or isn't a valid object file
+   */
+  explicit ObjectFile(const std::string &theFile);
+
+  /**
+   * Copy constructor
+   */
+  ObjectFile(const ObjectFile &) = delete;
+
+  /**
+   * Move constructor
+   */
+  ObjectFile(ObjectFile &&) = delete;
+
+  /**
+   * Destructor. Unmaps the file.
+   */
+  ~ObjectFile();
+
+  /**
+   * Copy assignment operator
+   */
+  ObjectFile& operator=(const ObjectFile &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  ObjectFile& operator=(ObjectFile &&) = delete;
+
+  /**
+   * Returns the constant pool.
+   *
+   * @return getHeader().myConstantCount constants
+   */
+  const int64_t* getConstants() const noexcept;
+
+  /**
+   * Returns the header.
+   *
+   * @return header
+   */
+  const Header& getHeader() const noexcept;
+
+  /**
+   * Returns the source line of each operation.
+   *
+   * @return getHeader().myOperationCount lines
+   */
+  const uint32_t* getLines() const noexcept;
+
+  /**
+   * Returns the native code, mapped executable.
+   *
+   * @return code (run with a frame of getHeader().myConstantBase slots), or
+   *         nullptr if the file has none (or it can't be mapped executable)
+   */
+  const void* getNativeCode() const noexcept;
+
+  /**
+   * Returns the bytecode.
+   *
+   * @return getHeader().myOperationCount operations, ending with Halt
+   */
+  const Bytecode::Operation* getOperations() const noexcept;
+
+  /**
+   * Returns the name of the source file, as it was compiled (relative to
+   * the directory it was compiled in).
+   *
+   * @return source file
+   */
+  std::string getSource() const;
+
+  /**
+   * Returns the overflow traps of the native code.
+   *
+   * @return getHeader().myTrapCount traps (see JitBackend::getTraps)
+   */
+  const uint32_t* getTraps() const noexcept;
+
+  /**
+   * Returns the FNV-1a hash of a file's contents.
+   *
+   * @param theFile
+   *          file
+   * @return hash
+   * @throws std::runtime_error
+   *           if the file can't be read
+   */
+  static uint64_t hash(const std::string &theFile);
+
+  /**
+   * Returns if a file starts as an object file does.
+   *
+   * @param theFile
+   *          file
+   * @return true if the file is (probably) an object file
+   */
+  static bool isObject(const std::string &theFile) noexcept;
+
+  /**
+   * Returns if the source file has changed since it was compiled. A source
+   * which can't be read (e.g., from another directory) isn't checked.
+   *
+   * @return true if the source file's hash differs from the one recorded
+   */
+  bool isOutOfDate() const noexcept;
+
+  /**
+   * Writes an object file.
+   *
+   * @param theFile
+   *          file to write
+   * @param theProgram
+   *          program (for the symbol table)
+   * @param theBytecode
+   *          program's bytecode
+   * @param theNativeCode
+   *          program's JIT code (empty for none)
+   * @param theTraps
+   *          its overflow traps (see JitBackend::getTraps)
+   * @param theSource
+   *          source file the program was compiled from
+   * @throws std::runtime_error
+   *           if the file can't be written or the source read
+   */
+  static void write(const std::string &theFile, const Program &theProgram,
+                    const Bytecode &theBytecode,
+                    const std::vector<uint8_t> &theNativeCode,
+                    const std::vector<uint32_t> &theTraps,
+                    const std::string &theSource);
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Checks the header and the bytecode.
+   *
+   * @param theFileSize
+   *          size of the mapped file
+   * @return description of the first problem, empty if none
+   */
+  std::string check(std::size_t theFileSize) const;
+
+  /**
+   * Unmaps the file and native code.
+   */
+  void unmap() noexcept;
+
+  /** Mapped file. */
+  const uint8_t *myAddress = nullptr;
+
+  /** Mapped native code (or nullptr). */
+  void *myNativeCode = nullptr;
+
+  /** Size of the native code mapping. */
+  std::size_t myNativeSize = 0;
+
+  /** Size of the file mapping. */
+  std::size_t mySize = 0;
+};
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file Operand.cpp
+ * @brief Implementation of Operand class
+ *
+ * @author Michael Albers
+ */
+
+#include "Operand.h"
+
+//**************************************************
+// Operand::Operand
+//**************************************************
+Operand::Operand(Kind theKind, int64_t theValue) :
+  myKind(theKind),
+  myValue(theValue)
+{
+}
+
+//**************************************************
+// Operand::operator==
+//**************************************************
+bool Operand::operator==(const Operand &theRHS) const noexcept
+{
+  return myKind == theRHS.myKind && myValue == theRHS.myValue;
+}
+
+//**************************************************
+// Operand::operator!=
+//**************************************************
+bool Operand::operator!=(const Operand &theRHS) const noexcept
+{
+  return ! (*this == theRHS);
+}
+
+//**************************************************
+// Operand::getIndex
+//**************************************************
+uint32_t Operand::getIndex() const noexcept
+{
+  return static_cast<uint32_t>(myValue);
+}
+
+//**************************************************
+// Operand::getKind
+//**************************************************
+Operand::Kind Operand::getKind() const noexcept
+{
+  return myKind;
+}
+
+//**************************************************
+// Operand::getValue
+//**************************************************
+int64_t Operand::getValue() const noexcept
+{
+  return myValue;
+}
+
+//**************************************************
+// Operand::isVariable
+//**************************************************
+bool Operand::isVariable() const noexcept
+{
+  return Kind::Symbol == myKind || Kind::Temporary == myKind;
+}
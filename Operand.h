@@ -0,0 +1,135 @@
+#ifndef OPERAND_H
+#define OPERAND_H
+
+/**
+ * @file Operand.h
+ * @brief Defines an operand of an intermediate code instruction.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+
+/**
+ * Operand of an intermediate code instruction: a literal value, a symbol
+ * (index into the program's symbol table) or a temporary (temporary number).
+ */
+class Operand
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  enum class Kind : uint8_t
+  {
+    None,
+    Literal,
+    Symbol,
+    Temporary
+  };
+
+  /**
+   * Default constructor. Creates an operand of kind None.
+   */
+  Operand() = default;
+
+  /**
+   * Copy constructor
+   */
+  Operand(const Operand &) = default;
+
+  /**
+   * Move constructor
+   */
+  Operand(Operand &&) = default;
+
+  /**
+   * Constructor
+   *
+   * @param theKind
+   *          kind of operand
+   * @param theValue
+   *          literal value, symbol index or temporary number
+   */
+  Operand(Kind theKind, int64_t theValue);
+
+  /**
+   * Destructor
+   */
+  ~Operand() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  Operand& operator=(const Operand &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  Operand& operator=(Operand &&) = default;
+
+  /**
+   * Equality operator.
+   *
+   * @param theRHS
+   *          right hand side of ==
+   * @return true if both are the same kind and value
+   */
+  bool operator==(const Operand &theRHS) const noexcept;
+
+  /**
+   * Inequality operator.
+   *
+   * @param theRHS
+   *          right hand side of !=
+   * @return true if the operands differ in kind or value
+   */
+  bool operator!=(const Operand &theRHS) const noexcept;
+
+  /**
+   * Returns the symbol index or temporary number.
+   *
+   * @return index of the operand
+   */
+  uint32_t getIndex() const noexcept;
+
+  /**
+   * Returns the operand kind.
+   *
+   * @return operand kind
+   */
+  Kind getKind() const noexcept;
+
+  /**
+   * Returns the literal value, symbol index or temporary number.
+   *
+   * @return operand value
+   */
+  int64_t getValue() const noexcept;
+
+  /**
+   * Returns if the operand names storage (i.e., is a symbol or temporary).
+   *
+   * @return true for symbols and temporaries
+   */
+  bool isVariable() const noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Operand kind. */
+  Kind myKind = Kind::None;
+
+  /** Literal value, symbol index or temporary number. */
+  int64_t myValue = 0;
+};
+
+#endif
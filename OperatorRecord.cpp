@@ -15,22 +15,86 @@
 OperatorRecord::OperatorRecord(Type theOperator) :
   Token(theOperator, 0, 0)
 {
-  if (theOperator != Type::PlusOp && theOperator != Type::MinusOp)
+  if (theOperator != Type::PlusOp && theOperator != Type::MinusOp &&
+      theOperator != Type::ExponentOp)
   {
     throw std::invalid_argument(
       "Illegal token type provided to OperatorRecord, " + getTokenString() +
-      ", must be either PlusOp or MinusOp.");
+      ", must be PlusOp, MinusOp or ExponentOp.");
+  }
+}
+
+//**************************************************
+// OperatorRecord::evaluate
+//**************************************************
+bool OperatorRecord::evaluate(int64_t theLeft, int64_t theRight,
+                              int64_t &theResult) const noexcept
+{
+  switch (getToken())
+  {
+    case Type::PlusOp:
+      return __builtin_add_overflow(theLeft, theRight, &theResult);
+
+    case Type::MinusOp:
+      return __builtin_sub_overflow(theLeft, theRight, &theResult);
+
+    default:
+      return power(theLeft, theRight, theResult);
   }
 }
 
 //**************************************************
 // OperatorRecord::getInstruction
 //**************************************************
-std::string OperatorRecord::getInstruction() const noexcept
+Instruction::OpCode OperatorRecord::getInstruction() const noexcept
 {
-  if (Type::PlusOp == getToken())
+  switch (getToken())
+  {
+    case Type::PlusOp:
+      return Instruction::OpCode::Add;
+
+    case Type::MinusOp:
+      return Instruction::OpCode::Sub;
+
+    default:
+      return Instruction::OpCode::Pow;
+  }
+}
+
+//**************************************************
+// OperatorRecord::power
+//**************************************************
+bool OperatorRecord::power(int64_t theBase, int64_t theExponent,
+                           int64_t &theResult) noexcept
+{
+  if (theExponent < 0)
+  {
+    if (1 == theBase || -1 == theBase)
+    {
+      theResult = (theExponent & 1) ? theBase : 1;
+    }
+    else
+    {
+      theResult = 0;
+    }
+    return 0 == theBase;
+  }
+
+  // Square and multiply; the wrapped result is kept going on overflow.
+  bool overflow = false;
+  int64_t result = 1;
+  int64_t square = theBase;
+  for (uint64_t exponent = theExponent; exponent != 0; exponent >>= 1)
   {
-    return "ADD";
+    if (exponent & 1)
+    {
+      overflow |= __builtin_mul_overflow(result, square, &result);
+    }
+    if (exponent > 1)
+    {
+      overflow |= __builtin_mul_overflow(square, square, &square);
+    }
   }
-  return "SUB";
+  theResult = result;
+  return overflow;
 }
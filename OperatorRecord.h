@@ -8,6 +8,7 @@
  * @author Michael Albers
  */
 
+#include "Instruction.h"
 #include "Token.h"
 
 /**
@@ -39,7 +40,7 @@ class OperatorRecord : public Token
    * Constructor
    *
    * @param theOperator
-   *          token (must be either plus or minus)
+   *          token (must be plus, minus or exponent)
    * @throws std::invalid_argument on invalid token type
    */
   OperatorRecord(Type theOperator);
@@ -72,7 +73,40 @@ class OperatorRecord : public Token
    *
    * @return the instruction for this operator.
    */
-  std::string getInstruction() const noexcept;
+  Instruction::OpCode getInstruction() const noexcept;
+
+  /**
+   * Applies this operator to two values, detecting signed 64-bit overflow.
+   *
+   * @param theLeft
+   *          left operand
+   * @param theRight
+   *          right operand
+   * @param theResult
+   *          set to the result (wrapped to 64 bits on overflow)
+   * @return true if the operation overflowed, otherwise false
+   */
+  bool evaluate(int64_t theLeft, int64_t theRight, int64_t &theResult)
+    const noexcept;
+
+  /**
+   * Integer exponentiation, as done by the Pow instruction. A negative
+   * exponent gives the integer part of 1 / theBase ** -theExponent: 1 or -1
+   * for a base of 1 or -1, 0 for any other base. For a base of 0 that
+   * divides by zero; the result is 0, but like an overflow it stops checked
+   * code.
+   *
+   * @param theBase
+   *          base
+   * @param theExponent
+   *          exponent
+   * @param theResult
+   *          set to the result (wrapped to 64 bits on overflow)
+   * @return true if the operation overflowed or divided by zero, otherwise
+   *         false
+   */
+  static bool power(int64_t theBase, int64_t theExponent, int64_t &theResult)
+    noexcept;
 
   // ************************************************************
   // Protected
@@ -0,0 +1,16 @@
+/**
+ * @file OutputSink.cpp
+ * @brief Implementation of OutputSink class
+ *
+ * @author Michael Albers
+ */
+
+#include "OutputSink.h"
+
+//**************************************************
+// OutputSink::write
+//**************************************************
+void OutputSink::write(const std::string &theString) noexcept
+{
+  write(theString.data(), theString.size());
+}
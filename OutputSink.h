@@ -0,0 +1,93 @@
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+/**
+ * @file OutputSink.h
+ * @brief Defines the interface for destinations of generated code.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Destination for generated code. Code is written to a sink as it is
+ * generated, so the sink decides whether any of it is kept in memory.
+ */
+class OutputSink
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  OutputSink() = default;
+
+  /**
+   * Copy constructor
+   */
+  OutputSink(const OutputSink &) = delete;
+
+  /**
+   * Move constructor
+   */
+  OutputSink(OutputSink &&) = delete;
+
+  /**
+   * Destructor
+   */
+  virtual ~OutputSink() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  OutputSink& operator=(const OutputSink &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  OutputSink& operator=(OutputSink &&) = delete;
+
+  /**
+   * Forces any buffered output to its final destination.
+   *
+   * @throws std::runtime_error
+   *           if any output could not be written
+   */
+  virtual void flush() = 0;
+
+  /**
+   * Writes data to the sink. Errors are deferred until flush is called so
+   * code generation is never interrupted.
+   *
+   * @param theData
+   *          data to write
+   * @param theLength
+   *          number of bytes in theData
+   */
+  virtual void write(const char *theData, std::size_t theLength) noexcept = 0;
+
+  /**
+   * Writes a string to the sink.
+   *
+   * @param theString
+   *          string to write
+   */
+  void write(const std::string &theString) noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+};
+
+#endif
@@ -8,7 +8,9 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
+#include "CompilerOptions.h"
 #include "ErrorWarningTracker.h"
 #include "ExpressionRecord.h"
 #include "OperatorRecord.h"
@@ -19,10 +21,12 @@
 //***************
 Parser::Parser(Scanner &theScanner,
                CodeGenerator &theGenerator,
-               ErrorWarningTracker &theEWTracker) :
+               ErrorWarningTracker &theEWTracker,
+               const CompilerOptions &theOptions) :
   myASTRoot{std::string("<system goal>")},
   myGenerator{theGenerator},
   myEWTracker{theEWTracker},
+  myOptions{theOptions},
   myScanner{theScanner}
 {
 }
@@ -76,95 +80,81 @@ void Parser::addOp(OperatorRecord &theOperator)
 //*******************
 void Parser::expression(ExpressionRecord &theExpression)
 {
-  // ID number for each call of this function (for tracking recursive calls)
-  static uint32_t callId = 0;
-  static bool generateQuick = false;
-  static OperatorRecord oldOperator(Token::Type::PlusOp);
-  static ExpressionRecord oldLHS;
-
-  // Set to true to generate code for left associative operators. Set to false
-  // for right-associative code generation.
-  // Left associativity doesn't work 100%.
-  //   A := (B - C) + D - (E - F);
-  // gets evaluated incorrectly. The basic idea is to save some state from a
-  // previous call to expression, then on the next (recursive) call, use that
-  // state for immediate code generation, thus simulating a left-associative
-  // grammar.
-  bool leftAssociative = true;
-
-  ++callId;
-  std::string function{"expression[" + std::to_string(callId) + "]"};
-  printFunction(function);
+  printFunction("expression");
 
-  auto primaryNode = myParentNode.top()->addChild("<primary>");
+  // <expression> -> <factor> {<add op> <factor>}
+  // Implemented as a loop so code is generated left associatively (and
+  // long expressions don't recurse deeply).
+  auto factorNode = myParentNode.top()->addChild("<factor>");
   printParse(8);
-
-  myParentNode.push(primaryNode);
-  ExpressionRecord leftOperand;
-  primary(leftOperand);
-  ExpressionRecord rightOperandForPrevious(leftOperand);
-
-  if (generateQuick)
-  {
-    generateQuick = false;
-    theExpression = myGenerator.generateInfix(
-      oldLHS, oldOperator, rightOperandForPrevious);
-    oldLHS = theExpression;
-  }
-  else
-  {
-    // This is for handling 'B - (C - D)'. Don't really understand why it works.
-    theExpression = oldLHS;
-
-    // Save left operand on first pass through expression (will be used
-    // on the next call for evaluation).
-    oldLHS = leftOperand;
-  }
+  myParentNode.push(factorNode);
+  factor(theExpression);
 
   Token peekToken(myScanner.peek());
-  if (peekToken.getToken() == Token::Type::PlusOp ||
-      peekToken.getToken() == Token::Type::MinusOp)
+  while (peekToken.getToken() == Token::Type::PlusOp ||
+         peekToken.getToken() == Token::Type::MinusOp)
   {
     auto addNode = myParentNode.top()->addChild("<add op>");
-    auto expressionNode = myParentNode.top()->addChild("<expression>");
+    factorNode = myParentNode.top()->addChild("<factor>");
     printParse(8);
 
     myParentNode.push(addNode);
     OperatorRecord operatorRecord(Token::Type::PlusOp);
     addOp(operatorRecord);
-    oldOperator = operatorRecord;
 
-    myParentNode.push(expressionNode);
+    myParentNode.push(factorNode);
     ExpressionRecord rightOperand;
-    if (leftAssociative && myScanner.peek().getToken() != Token::Type::LParen)
-    {
-      generateQuick = true;
-      expression(theExpression);
-    }
-    else
-    {
-      expression(rightOperand);
+    factor(rightOperand);
 
-      theExpression = myGenerator.generateInfix(
-        leftOperand, operatorRecord, rightOperand);
-    }
+    theExpression = myGenerator.generateInfix(
+      theExpression, operatorRecord, rightOperand);
+    peekToken = myScanner.peek();
   }
-  else
+
+  myParentNode.pop();
+}
+
+//***************
+// Parser::factor
+//***************
+void Parser::factor(ExpressionRecord &theExpression)
+{
+  printFunction("factor");
+
+  // <factor> -> <primary> [** <factor>]
+  // Exponentiation is right associative: all of the operands are parsed,
+  // then code is generated from the right.
+  std::vector<ExpressionRecord> operands(1);
+  auto primaryNode = myParentNode.top()->addChild("<primary>");
+  printParse(15);
+  myParentNode.push(primaryNode);
+  primary(operands.back());
+
+  OperatorRecord operatorRecord(Token::Type::ExponentOp);
+  Token peekToken(myScanner.peek());
+  while (peekToken.getToken() == Token::Type::ExponentOp)
   {
-    if (leftAssociative)
-    {
-      theExpression = oldLHS;
-    }
-    else
-    {
-      theExpression = leftOperand;
-    }
+    myParentNode.top()->addChild(peekToken);
+    primaryNode = myParentNode.top()->addChild("<primary>");
+    printParse(16);
+    match(Token::Type::ExponentOp);
+    operatorRecord = myGenerator.processOperator(
+      myScanner.getCurrentToken().getLiteral());
+
+    operands.emplace_back();
+    myParentNode.push(primaryNode);
+    primary(operands.back());
+    peekToken = myScanner.peek();
   }
 
+  theExpression = operands.back();
+  for (auto operand = operands.rbegin() + 1; operand != operands.rend();
+       ++operand)
+  {
+    theExpression = myGenerator.generateInfix(*operand, operatorRecord,
+                                              theExpression);
+  }
   myParentNode.pop();
-  std::cout << "Return from expression[" << callId << "]" << std::endl;
-
-  --callId;
 }
 
 //*****************
@@ -205,8 +195,7 @@ void Parser::ident(ExpressionRecord &theIdentifier)
   printFunction("ident");
 
   match(Token::Type::Id);
-  theIdentifier = myGenerator.processId(
-    myScanner.getCurrentToken().getLiteral());
+  theIdentifier = myGenerator.processId(myScanner.getCurrentToken());
 
   myParentNode.top()->addChild(new ASTNode{myScanner.getCurrentToken()});
   printParse(10);
@@ -280,9 +269,7 @@ void Parser::primary(ExpressionRecord &theExpression)
       myParentNode.top()->addChild(new ASTNode(peekToken));
       printParse(11);
       match(Token::Type::IntLiteral);
-      theExpression = ExpressionRecord(
-        ExpressionRecord::Type::Literal,
-        myScanner.getCurrentToken().getLiteral());
+      theExpression = myGenerator.processLiteral(myScanner.getCurrentToken());
     }
     break;
 
@@ -324,6 +311,7 @@ void Parser::statement()
   printFunction("statement");
 
   Token peekToken(myScanner.peek());
+  myGenerator.setLine(peekToken.getLine());
   switch (peekToken.getToken())
   {
     case Token::Type::Id:
@@ -343,7 +331,7 @@ void Parser::statement()
       myParentNode.push(expressionNode);
       ExpressionRecord expressionRecord;
       expression(expressionRecord);
-      myGenerator.assign(identifier, expressionRecord);
+      myGenerator.assign(expressionRecord, identifier);
 
       match(Token::Type::SemiColon);
     }
@@ -398,34 +386,39 @@ void Parser::statement()
 //**********************
 void Parser::statementList()
 {
-  printFunction("statementList");
+  // The production is right recursive; it is implemented as a loop (which
+  // builds the same tree) so long programs don't exhaust the stack. One pop
+  // is owed for each nested <statement list> node.
+  uint32_t nestedLists = 0;
+  while (true)
+  {
+    printFunction("statementList");
 
-  auto statementNode = myParentNode.top()->addChild("<statement>");
-  printParse(2);
+    auto statementNode = myParentNode.top()->addChild("<statement>");
+    printParse(2);
 
-  myParentNode.push(statementNode);
-  statement();
+    myParentNode.push(statementNode);
+    statement();
 
-  Token peekToken(myScanner.peek());
-  switch (peekToken.getToken())
-  {
-    case Token::Type::Id:
-    case Token::Type::ReadSym:
-    case Token::Type::WriteSym:
+    Token peekToken(myScanner.peek());
+    if (peekToken.getToken() != Token::Type::Id &&
+        peekToken.getToken() != Token::Type::ReadSym &&
+        peekToken.getToken() != Token::Type::WriteSym)
     {
-      auto statmentListNode = myParentNode.top()->addChild("<statement list>");
-      printParse(2);
-
-      myParentNode.push(statmentListNode);
-      statementList();
+      break;
     }
-    break;
 
-    default:
-      // Nothing to do here. Default needed to suppress warning.
-      break;
+    auto statmentListNode = myParentNode.top()->addChild("<statement list>");
+    printParse(2);
+
+    myParentNode.push(statmentListNode);
+    ++nestedLists;
+  }
+
+  for (uint32_t ii = 0; ii <= nestedLists; ++ii)
+  {
+    myParentNode.pop();
   }
-  myParentNode.pop();
 }
 
 //*******************
@@ -453,9 +446,12 @@ void Parser::systemGoal()
 //**************
 void Parser::match(const Token::Type &theToken) noexcept
 {
-  Token temp(theToken, 0, 0);
-  std::string function{"match(" + temp.getTokenString() + ")"};
-  printFunction(function);
+  if (myOptions.isTraceEnabled())
+  {
+    Token temp(theToken, 0, 0);
+    std::string function{"match(" + temp.getTokenString() + ")"};
+    printFunction(function);
+  }
 
   Token nextToken = myScanner.nextToken();
   if (nextToken.getToken() != theToken)
@@ -469,6 +465,10 @@ void Parser::match(const Token::Type &theToken) noexcept
 //**********************
 void Parser::printFunction(const std::string &theFunction)
 {
+  if (! myOptions.isTraceEnabled())
+  {
+    return;
+  }
   std::cout << "Call " << std::setw(18) << std::left << theFunction
             << "   Remaining: "
             << myScanner.remainingSource() << std::endl;
@@ -480,6 +480,12 @@ void Parser::printFunction(const std::string &theFunction)
 void Parser::printParse(uint32_t theProduction,
                         const char *theProductionName) const noexcept
 {
+  // Walking the tree for every production is quadratic in program size, so
+  // only do it when tracing.
+  if (! myOptions.isTraceEnabled())
+  {
+    return;
+  }
   std::ostringstream output;
   output << std::setw(13) << theProductionName << " "
          << std::setw(2) << theProduction << " --> ";
@@ -15,6 +15,7 @@
 #include "CodeGenerator.h"
 #include "Scanner.h"
 
+class CompilerOptions;
 class ErrorWarningTracker;
 class ExpressionRecord;
 class OperatorRecord;
@@ -53,10 +54,13 @@ class Parser
    *          code generator object
    * @param theEWTracker
    *          object to track and report errors and warnings
+   * @param theOptions
+   *          command line options
    */
   Parser(Scanner &theScanner,
          CodeGenerator &theGenerator,
-         ErrorWarningTracker &theEWTracker);
+         ErrorWarningTracker &theEWTracker,
+         const CompilerOptions &theOptions);
 
   /**
    * Destructor
@@ -94,6 +98,7 @@ class Parser
   void addOp(OperatorRecord &theOperator);
   void expression(ExpressionRecord &theExpression);
   void exprList();
+  void factor(ExpressionRecord &theExpression);
   void ident(ExpressionRecord &theIdentifier);
   void idList();
   void primary(ExpressionRecord &theExpression);
@@ -146,6 +151,9 @@ class Parser
   /** Object to track and report errors and warnings */
   ErrorWarningTracker &myEWTracker;
 
+  /** Command line options. */
+  const CompilerOptions &myOptions;
+
   /** Token scanner */
   Scanner &myScanner;
 };
@@ -0,0 +1,25 @@
+/**
+ * @file Pass.cpp
+ * @brief Implementation of Pass class
+ *
+ * @author Michael Albers
+ */
+
+#include "AnalysisManager.h"
+#include "Pass.h"
+
+//**************************************************
+// Pass::getPreservedAnalyses
+//**************************************************
+uint32_t Pass::getPreservedAnalyses() const noexcept
+{
+  return myChanged ? AnalysisManager::NONE : AnalysisManager::ALL;
+}
+
+//**************************************************
+// Pass::setChanged
+//**************************************************
+void Pass::setChanged(bool theChanged) noexcept
+{
+  myChanged = theChanged;
+}
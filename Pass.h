@@ -0,0 +1,113 @@
+#ifndef PASS_H
+#define PASS_H
+
+/**
+ * @file Pass.h
+ * @brief Defines the interface of an intermediate code optimization pass.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+
+class AnalysisManager;
+class Program;
+class Statistics;
+
+/**
+ * An optimization pass. A pass transforms a program in place without
+ * changing its observable behavior (the values written, in order).
+ *
+ * Analyses are shared through an AnalysisManager. A pass declares which of
+ * them are still valid after it has run (see getPreservedAnalyses) so the
+ * pass manager only discards those the pass may have broken.
+ */
+class Pass
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  Pass() = default;
+
+  /**
+   * Copy constructor
+   */
+  Pass(const Pass &) = delete;
+
+  /**
+   * Move constructor
+   */
+  Pass(Pass &&) = delete;
+
+  /**
+   * Destructor
+   */
+  virtual ~Pass() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  Pass& operator=(const Pass &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  Pass& operator=(Pass &&) = delete;
+
+  /**
+   * Returns the name of the pass (for statistics and diagnostics).
+   *
+   * @return pass name
+   */
+  virtual const char* getName() const noexcept = 0;
+
+  /**
+   * Returns the analyses still valid after the last run of the pass. A pass
+   * which changed nothing preserves them all; otherwise, unless it says
+   * different, none.
+   *
+   * @return AnalysisManager::Analysis flags
+   */
+  virtual uint32_t getPreservedAnalyses() const noexcept;
+
+  /**
+   * Runs the pass.
+   *
+   * @param theProgram
+   *          program to transform
+   * @param theAnalyses
+   *          analyses of the program
+   * @param theStatistics
+   *          statistics to add to
+   */
+  virtual void run(Program &theProgram, AnalysisManager &theAnalyses,
+                   Statistics &theStatistics) = 0;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  /**
+   * Records whether the current run changed the program.
+   *
+   * @param theChanged
+   *          true if anything was changed
+   */
+  void setChanged(bool theChanged) noexcept;
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Did the last run change the program? */
+  bool myChanged = true;
+};
+
+#endif
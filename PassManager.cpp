@@ -0,0 +1,96 @@
+/**
+ * @file PassManager.cpp
+ * @brief Implementation of PassManager class
+ *
+ * @author Michael Albers
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <utility>
+
+#include <sys/resource.h>
+
+#include "PassManager.h"
+#include "Program.h"
+#include "Statistics.h"
+
+//**************************************************
+// PassManager::add
+//**************************************************
+void PassManager::add(std::unique_ptr<Pass> thePass)
+{
+  myPasses.push_back(std::move(thePass));
+}
+
+//**************************************************
+// PassManager::getPeakMemory
+//**************************************************
+long PassManager::getPeakMemory() noexcept
+{
+  struct rusage usage;
+  return (0 == getrusage(RUSAGE_SELF, &usage)) ? usage.ru_maxrss : 0;
+}
+
+//**************************************************
+// PassManager::getRecords
+//**************************************************
+const std::vector<PassManager::Record>& PassManager::getRecords()
+  const noexcept
+{
+  return myRecords;
+}
+
+//**************************************************
+// PassManager::print
+//**************************************************
+void PassManager::print(std::ostream &theOS) const
+{
+  theOS << std::left << std::setw(22) << "pass" << std::right
+        << std::setw(12) << "time (us)" << std::setw(10) << "before"
+        << std::setw(10) << "after" << std::setw(14) << "memory (KiB)"
+        << std::endl;
+
+  uint64_t microseconds = 0;
+  for (auto &record : myRecords)
+  {
+    theOS << std::left << std::setw(22) << record.myName << std::right
+          << std::setw(12) << record.myMicroseconds
+          << std::setw(10) << record.myInstructionsBefore
+          << std::setw(10) << record.myInstructionsAfter
+          << std::setw(14) << record.myPeakMemoryGrowth << std::endl;
+    microseconds += record.myMicroseconds;
+  }
+
+  theOS << std::left << std::setw(22) << "total" << std::right
+        << std::setw(12) << microseconds << std::endl
+        << myAnalyses.getComputedCount() << " analyses computed, "
+        << myAnalyses.getReusedCount() << " reused" << std::endl;
+}
+
+//**************************************************
+// PassManager::run
+//**************************************************
+void PassManager::run(Program &theProgram, Statistics &theStatistics)
+{
+  using Clock = std::chrono::steady_clock;
+
+  for (auto &pass : myPasses)
+  {
+    Record record;
+    record.myName = pass->getName();
+    record.myInstructionsBefore = theProgram.getInstructions().size();
+    auto memory = getPeakMemory();
+    auto start = Clock::now();
+
+    pass->run(theProgram, myAnalyses, theStatistics);
+
+    record.myMicroseconds = std::chrono::duration_cast<
+      std::chrono::microseconds>(Clock::now() - start).count();
+    record.myPeakMemoryGrowth = getPeakMemory() - memory;
+    record.myInstructionsAfter = theProgram.getInstructions().size();
+    myRecords.push_back(record);
+
+    myAnalyses.invalidate(pass->getPreservedAnalyses());
+  }
+}
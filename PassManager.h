@@ -0,0 +1,147 @@
+#ifndef PASSMANAGER_H
+#define PASSMANAGER_H
+
+/**
+ * @file PassManager.h
+ * @brief Defines the runner of the optimization pipeline.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "AnalysisManager.h"
+#include "Pass.h"
+
+class Program;
+class Statistics;
+
+/**
+ * Runs a pipeline of optimization passes over a program, in the order they
+ * were added. Analyses are shared between the passes through an
+ * AnalysisManager; after each pass those it doesn't preserve are discarded.
+ *
+ * The cost and effect of each pass is recorded: wall time, the number of
+ * instructions before and after, and the growth of the peak resident set
+ * size while it ran.
+ */
+class PassManager
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** What one pass cost and did. */
+  struct Record
+  {
+    /** Pass name. */
+    const char *myName;
+
+    /** Wall time, in microseconds. */
+    uint64_t myMicroseconds;
+
+    /** Number of instructions before the pass. */
+    std::size_t myInstructionsBefore;
+
+    /** Number of instructions after the pass. */
+    std::size_t myInstructionsAfter;
+
+    /** Growth of the peak resident set size, in KiB. */
+    long myPeakMemoryGrowth;
+  };
+
+  /**
+   * Default constructor.
+   */
+  PassManager() = default;
+
+  /**
+   * Copy constructor
+   */
+  PassManager(const PassManager &) = delete;
+
+  /**
+   * Move constructor
+   */
+  PassManager(PassManager &&) = default;
+
+  /**
+   * Destructor
+   */
+  ~PassManager() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  PassManager& operator=(const PassManager &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  PassManager& operator=(PassManager &&) = default;
+
+  /**
+   * Adds a pass to the end of the pipeline.
+   *
+   * @param thePass
+   *          pass
+   */
+  void add(std::unique_ptr<Pass> thePass);
+
+  /**
+   * Returns the records of the passes run, in order.
+   *
+   * @return pass records
+   */
+  const std::vector<Record>& getRecords() const noexcept;
+
+  /**
+   * Prints a table of the pass records.
+   *
+   * @param theOS
+   *          stream to print to
+   */
+  void print(std::ostream &theOS) const;
+
+  /**
+   * Runs every pass over a program.
+   *
+   * @param theProgram
+   *          program to transform
+   * @param theStatistics
+   *          statistics to add to
+   */
+  void run(Program &theProgram, Statistics &theStatistics);
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Returns the peak resident set size of the process so far.
+   *
+   * @return peak size, in KiB
+   */
+  static long getPeakMemory() noexcept;
+
+  /** Analyses shared by the passes. */
+  AnalysisManager myAnalyses;
+
+  /** Pipeline, in order. */
+  std::vector<std::unique_ptr<Pass>> myPasses;
+
+  /** Record of each pass run. */
+  std::vector<Record> myRecords;
+};
+
+#endif
@@ -0,0 +1,358 @@
+/**
+ * @file Peephole.cpp
+ * @brief Implementation of Peephole class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+#include "Peephole.h"
+#include "Program.h"
+#include "Statistics.h"
+#include "TextBackend.h"
+
+//**************************************************
+// Peephole::RULES
+//**************************************************
+const Peephole::RuleText Peephole::RULES[] = {
+  {"add-zero", "ADD x, #0, d", "Store x, d"},
+  {"zero-add", "ADD #0, x, d", "Store x, d"},
+  {"sub-zero", "SUB x, #0, d", "Store x, d"},
+  {"sub-self", "SUB x, x, d", "Store #0, d"},
+  {"mul-one", "MUL x, #1, d", "Store x, d"},
+  {"one-mul", "MUL #1, x, d", "Store x, d"},
+  {"mul-zero", "MUL x, #0, d", "Store #0, d"},
+  {"zero-mul", "MUL #0, x, d", "Store #0, d"},
+  {"store-self", "Store x, x", ""},
+  {"add-store", "ADD a, b, %t; Store %t, d", "ADD a, b, d"},
+  {"sub-store", "SUB a, b, %t; Store %t, d", "SUB a, b, d"},
+  {"mul-store", "MUL a, b, %t; Store %t, d", "MUL a, b, d"},
+  {"pow-store", "POW a, b, %t; Store %t, d", "POW a, b, d"},
+  {"store-store", "Store x, %t; Store %t, d", "Store x, d"},
+};
+
+//**************************************************
+// Peephole::Peephole
+//**************************************************
+Peephole::Peephole()
+{
+  for (auto &text : RULES)
+  {
+    std::vector<std::string> variables;
+    Rule rule;
+    rule.myName = text.myName;
+    rule.myPattern = compile(text, text.myPattern, variables, rule.mySingleUse,
+                             false);
+    rule.myReplacement = compile(text, text.myReplacement, variables,
+                                 rule.mySingleUse, true);
+    if (rule.myPattern.empty())
+    {
+      throw std::logic_error(std::string("Empty peephole rule: ") +
+                             text.myName);
+    }
+    myRules.push_back(std::move(rule));
+  }
+}
+
+//**************************************************
+// Peephole::compile
+//**************************************************
+std::vector<Peephole::InstructionPattern> Peephole::compile(
+  const RuleText &theRule, const std::string &theText,
+  std::vector<std::string> &theVariables, std::vector<bool> &theSingleUse,
+  bool isReplacement)
+{
+  static const Instruction::OpCode opCodes[] = {
+    Instruction::OpCode::Declare, Instruction::OpCode::Read,
+    Instruction::OpCode::Write, Instruction::OpCode::Store,
+    Instruction::OpCode::Add, Instruction::OpCode::Sub,
+    Instruction::OpCode::Mul, Instruction::OpCode::Pow,
+    Instruction::OpCode::Halt};
+
+  std::vector<InstructionPattern> patterns;
+  std::istringstream instructions(theText);
+  std::string text;
+  while (std::getline(instructions, text, ';'))
+  {
+    auto malformed = [&](const std::string &theReason)
+    {
+      return std::logic_error(std::string("Malformed peephole rule ") +
+                              theRule.myName + " (" + theReason + "): " +
+                              text);
+    };
+
+    std::istringstream fields(text);
+    std::string mnemonic;
+    if (! (fields >> mnemonic))
+    {
+      continue;
+    }
+
+    InstructionPattern pattern;
+    auto opCode = std::find_if(
+      std::begin(opCodes), std::end(opCodes),
+      [&](Instruction::OpCode theOpCode)
+      {
+        return mnemonic == TextBackend::getMnemonic(theOpCode);
+      });
+    if (std::end(opCodes) == opCode)
+    {
+      throw malformed("unknown instruction");
+    }
+    pattern.myOpCode = *opCode;
+
+    std::string operand;
+    while (std::getline(fields, operand, ','))
+    {
+      auto first = operand.find_first_not_of(" \t");
+      auto last = operand.find_last_not_of(" \t");
+      if (std::string::npos == first)
+      {
+        throw malformed("missing operand");
+      }
+      operand = operand.substr(first, last - first + 1);
+
+      OperandPattern operandPattern;
+      if ('#' == operand[0])
+      {
+        char *end = nullptr;
+        errno = 0;
+        operandPattern.myLiteral = true;
+        operandPattern.myValue = std::strtoll(operand.c_str() + 1, &end, 10);
+        if (operand.size() == 1 || *end != '\0' || errno != 0)
+        {
+          throw malformed("bad literal");
+        }
+      }
+      else
+      {
+        bool singleUse = ('%' == operand[0]);
+        auto name = singleUse ? operand.substr(1) : operand;
+        auto variable = std::find(theVariables.begin(), theVariables.end(),
+                                  name);
+        if (theVariables.end() == variable)
+        {
+          if (isReplacement)
+          {
+            throw malformed("unbound variable " + name);
+          }
+          variable = theVariables.insert(theVariables.end(), name);
+          theSingleUse.push_back(false);
+        }
+        operandPattern.myValue = variable - theVariables.begin();
+        if (singleUse && ! isReplacement)
+        {
+          theSingleUse[operandPattern.myValue] = true;
+        }
+      }
+      pattern.myOperands.push_back(operandPattern);
+    }
+
+    Instruction instruction(pattern.myOpCode);
+    uint32_t operands = instruction.getSourceCount() +
+      (instruction.hasDestination() ? 1 : 0);
+    if (Instruction::OpCode::Declare == pattern.myOpCode)
+    {
+      operands = 1;
+    }
+    if (pattern.myOperands.size() != operands)
+    {
+      throw malformed("wrong number of operands");
+    }
+    patterns.push_back(std::move(pattern));
+  }
+  return patterns;
+}
+
+//**************************************************
+// Peephole::countReads
+//**************************************************
+void Peephole::countReads(const Instruction &theInstruction,
+                          int theDelta) noexcept
+{
+  for (uint32_t source = 0; source < theInstruction.getSourceCount(); ++source)
+  {
+    auto &operand = theInstruction.getOperand(source);
+    if (Operand::Kind::Temporary == operand.getKind())
+    {
+      myReads[operand.getIndex()] += theDelta;
+    }
+  }
+}
+
+//**************************************************
+// Peephole::getName
+//**************************************************
+const char* Peephole::getName() const noexcept
+{
+  return "peephole";
+}
+
+//**************************************************
+// Peephole::match
+//**************************************************
+bool Peephole::match(const Rule &theRule,
+                     const std::vector<Instruction> &theCode,
+                     std::vector<Operand> &theBindings) const
+{
+  if (theCode.size() < theRule.myPattern.size())
+  {
+    return false;
+  }
+
+  auto start = theCode.size() - theRule.myPattern.size();
+  theBindings.assign(theRule.mySingleUse.size(), Operand());
+  for (std::size_t ii = 0; ii < theRule.myPattern.size(); ++ii)
+  {
+    auto &pattern = theRule.myPattern[ii];
+    auto &instruction = theCode[start + ii];
+    if (pattern.myOpCode != instruction.getOpCode())
+    {
+      return false;
+    }
+
+    for (uint32_t jj = 0; jj < pattern.myOperands.size(); ++jj)
+    {
+      auto &operandPattern = pattern.myOperands[jj];
+      auto &operand = instruction.getOperand(jj);
+      if (operandPattern.myLiteral)
+      {
+        if (Operand::Kind::Literal != operand.getKind() ||
+            operandPattern.myValue != operand.getValue())
+        {
+          return false;
+        }
+      }
+      else
+      {
+        auto &binding = theBindings[operandPattern.myValue];
+        if (Operand::Kind::None == binding.getKind())
+        {
+          binding = operand;
+        }
+        else if (binding != operand)
+        {
+          return false;
+        }
+      }
+    }
+  }
+
+  // A single use temporary may only be read within the window.
+  for (std::size_t variable = 0; variable < theBindings.size(); ++variable)
+  {
+    if (! theRule.mySingleUse[variable])
+    {
+      continue;
+    }
+
+    auto &temporary = theBindings[variable];
+    if (Operand::Kind::Temporary != temporary.getKind())
+    {
+      return false;
+    }
+
+    uint32_t reads = 0;
+    for (auto ii = start; ii < theCode.size(); ++ii)
+    {
+      auto &instruction = theCode[ii];
+      for (uint32_t source = 0; source < instruction.getSourceCount();
+           ++source)
+      {
+        if (instruction.getOperand(source) == temporary)
+        {
+          ++reads;
+        }
+      }
+    }
+    if (reads != myReads[temporary.getIndex()])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//**************************************************
+// Peephole::run
+//**************************************************
+void Peephole::run(Program &theProgram, AnalysisManager &theAnalyses,
+                   Statistics &theStatistics)
+{
+  auto &instructions = theProgram.getInstructions();
+  myReads.assign(theProgram.getTemporaryCount() + 1, 0);
+  for (auto &instruction : instructions)
+  {
+    countReads(instruction, 1);
+  }
+
+  std::vector<uint64_t> hits(myRules.size(), 0);
+  std::vector<Instruction> code;
+  code.reserve(instructions.size());
+  // Replacements still to be moved to the output, last first.
+  std::vector<Instruction> pending;
+  std::vector<Operand> bindings;
+
+  std::size_t next = 0;
+  while (! pending.empty() || next < instructions.size())
+  {
+    if (! pending.empty())
+    {
+      code.push_back(pending.back());
+      pending.pop_back();
+    }
+    else
+    {
+      code.push_back(instructions[next++]);
+    }
+
+    for (std::size_t rule = 0; rule < myRules.size(); ++rule)
+    {
+      auto &current = myRules[rule];
+      if (! match(current, code, bindings))
+      {
+        continue;
+      }
+
+      // Replacements belong to the first matched instruction's line.
+      auto line = code[code.size() - current.myPattern.size()].getLine();
+      for (std::size_t ii = 0; ii < current.myPattern.size(); ++ii)
+      {
+        countReads(code.back(), -1);
+        code.pop_back();
+      }
+      for (auto replacement = current.myReplacement.rbegin();
+           replacement != current.myReplacement.rend(); ++replacement)
+      {
+        Operand operands[Instruction::MAX_OPERANDS];
+        for (uint32_t jj = 0; jj < replacement->myOperands.size(); ++jj)
+        {
+          auto &operandPattern = replacement->myOperands[jj];
+          operands[jj] = operandPattern.myLiteral ?
+            Operand(Operand::Kind::Literal, operandPattern.myValue) :
+            bindings[operandPattern.myValue];
+        }
+        pending.emplace_back(replacement->myOpCode, operands[0], operands[1],
+                             operands[2]);
+        pending.back().setLine(line);
+        countReads(pending.back(), 1);
+      }
+      ++hits[rule];
+      break;
+    }
+  }
+  instructions.swap(code);
+
+  uint64_t rewrites = 0;
+  for (std::size_t rule = 0; rule < myRules.size(); ++rule)
+  {
+    theStatistics.add("peephole " + myRules[rule].myName, hits[rule]);
+    rewrites += hits[rule];
+  }
+  setChanged(0 != rewrites);
+}
@@ -0,0 +1,178 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+/**
+ * @file Peephole.h
+ * @brief Defines the table driven peephole optimization pass.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Instruction.h"
+#include "Operand.h"
+#include "Pass.h"
+
+/**
+ * Table driven peephole optimizer. Each rule is a short sequence of
+ * instructions and its replacement, written as text in the same form as the
+ * generated code (see RULES in Peephole.cpp). Within a rule an operand is
+ * one of:
+ *
+ *  - "#n", the literal n,
+ *  - "x", any operand (repeated names must be the same operand), or
+ *  - "%x", a temporary which is read nowhere but within the matched
+ *    instructions (it is free to be removed or renamed).
+ *
+ * Instructions are moved one at a time to the output and, after each, the
+ * rules are tried (in table order) against the instructions at the end of
+ * the output. A replacement is fed back in ahead of the remaining input, so
+ * rewrites cascade.
+ *
+ * Relies on temporaries being assigned only once, so it must run before
+ * temporary allocation.
+ */
+class Peephole : public Pass
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Constructor. Compiles the rule table.
+   *
+   * @throws std::logic_error
+   *           if a rule is malformed
+   */
+  Peephole();
+
+  /**
+   * Destructor
+   */
+  virtual ~Peephole() = default;
+
+  virtual const char* getName() const noexcept override;
+
+  virtual void run(Program &theProgram, AnalysisManager &theAnalyses,
+                   Statistics &theStatistics) override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** A rule as written in the rule table. */
+  struct RuleText
+  {
+    /** Rule name (for statistics). */
+    const char *myName;
+
+    /** Instructions to look for, separated by ';'. */
+    const char *myPattern;
+
+    /** Replacement instructions, separated by ';' (may be empty). */
+    const char *myReplacement;
+  };
+
+  /** Compiled operand of a pattern or replacement. */
+  struct OperandPattern
+  {
+    /** Matches only a literal. */
+    bool myLiteral = false;
+
+    /** Literal value (myLiteral) or variable number (otherwise). */
+    int64_t myValue = 0;
+  };
+
+  /** Compiled instruction of a pattern or replacement. */
+  struct InstructionPattern
+  {
+    /** Op code to match or generate. */
+    Instruction::OpCode myOpCode;
+
+    /** Operands, in instruction order. */
+    std::vector<OperandPattern> myOperands;
+  };
+
+  /** Compiled rule. */
+  struct Rule
+  {
+    /** Rule name. */
+    std::string myName;
+
+    /** Instructions to look for. */
+    std::vector<InstructionPattern> myPattern;
+
+    /** Replacement instructions. */
+    std::vector<InstructionPattern> myReplacement;
+
+    /** Is each variable a temporary read only within the pattern? */
+    std::vector<bool> mySingleUse;
+  };
+
+  /**
+   * Compiles one side of a rule.
+   *
+   * @param theRule
+   *          rule text (for diagnostics)
+   * @param theText
+   *          instructions, separated by ';'
+   * @param theVariables
+   *          names of the variables seen so far
+   * @param theSingleUse
+   *          single use flag of each variable seen so far
+   * @param isReplacement
+   *          compiling a replacement (all variables must already be known)
+   * @return compiled instructions
+   * @throws std::logic_error
+   *           if the text is malformed
+   */
+  static std::vector<InstructionPattern> compile(
+    const RuleText &theRule, const std::string &theText,
+    std::vector<std::string> &theVariables, std::vector<bool> &theSingleUse,
+    bool isReplacement);
+
+  /**
+   * Adjusts the read count of each temporary read by an instruction.
+   *
+   * @param theInstruction
+   *          instruction
+   * @param theDelta
+   *          +1 or -1
+   */
+  void countReads(const Instruction &theInstruction, int theDelta) noexcept;
+
+  /**
+   * Tries to match a rule against the end of the code.
+   *
+   * @param theRule
+   *          rule to try
+   * @param theCode
+   *          code generated so far
+   * @param theBindings
+   *          on a match, the operand bound to each variable
+   * @return true if the rule matches
+   */
+  bool match(const Rule &theRule, const std::vector<Instruction> &theCode,
+             std::vector<Operand> &theBindings) const;
+
+  /** All of the peephole rules, in the order they are tried. */
+  static const RuleText RULES[];
+
+  /** Compiled rules. */
+  std::vector<Rule> myRules;
+
+  /** Number of reads of each temporary in the code being optimized. */
+  std::vector<uint32_t> myReads;
+};
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file Program.cpp
+ * @brief Implementation of Program class
+ *
+ * @author Michael Albers
+ */
+
+#include "Program.h"
+
+//**************************************************
+// Program::append
+//**************************************************
+void Program::append(const Instruction &theInstruction)
+{
+  myInstructions.push_back(theInstruction);
+}
+
+//**************************************************
+// Program::getInstructions
+//**************************************************
+std::vector<Instruction>& Program::getInstructions() noexcept
+{
+  return myInstructions;
+}
+
+//**************************************************
+// Program::getInstructions
+//**************************************************
+const std::vector<Instruction>& Program::getInstructions() const noexcept
+{
+  return myInstructions;
+}
+
+//**************************************************
+// Program::getName
+//**************************************************
+std::string Program::getName(const Operand &theOperand) const
+{
+  switch (theOperand.getKind())
+  {
+    case Operand::Kind::Literal:
+      return std::to_string(theOperand.getValue());
+
+    case Operand::Kind::Symbol:
+      return mySymbolTable.getSymbol(theOperand.getIndex());
+
+    case Operand::Kind::Temporary:
+      return "Temp&" + std::to_string(theOperand.getIndex());
+
+    default:
+      return "";
+  }
+}
+
+//**************************************************
+// Program::getSlot
+//**************************************************
+uint32_t Program::getSlot(const Operand &theOperand) const noexcept
+{
+  if (Operand::Kind::Temporary == theOperand.getKind())
+  {
+    return mySymbolTable.size() + theOperand.getIndex() - 1;
+  }
+  return theOperand.getIndex();
+}
+
+//**************************************************
+// Program::getSlotCount
+//**************************************************
+uint32_t Program::getSlotCount() const noexcept
+{
+  return mySymbolTable.size() + myTemporaryCount;
+}
+
+//**************************************************
+// Program::getSymbolTable
+//**************************************************
+SymbolTable& Program::getSymbolTable() noexcept
+{
+  return mySymbolTable;
+}
+
+//**************************************************
+// Program::getSymbolTable
+//**************************************************
+const SymbolTable& Program::getSymbolTable() const noexcept
+{
+  return mySymbolTable;
+}
+
+//**************************************************
+// Program::getTemporaryCount
+//**************************************************
+uint32_t Program::getTemporaryCount() const noexcept
+{
+  return myTemporaryCount;
+}
+
+//**************************************************
+// Program::newTemporary
+//**************************************************
+Operand Program::newTemporary() noexcept
+{
+  ++myTemporaryCount;
+  return Operand(Operand::Kind::Temporary, myTemporaryCount);
+}
+
+//**************************************************
+// Program::setTemporaryCount
+//**************************************************
+void Program::setTemporaryCount(uint32_t theCount) noexcept
+{
+  myTemporaryCount = theCount;
+}
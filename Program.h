@@ -0,0 +1,168 @@
+#ifndef PROGRAM_H
+#define PROGRAM_H
+
+/**
+ * @file Program.h
+ * @brief Defines the intermediate code of a whole program.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Instruction.h"
+#include "SymbolTable.h"
+
+/**
+ * Intermediate code for a program: a straight-line list of instructions and
+ * the symbols they refer to. Temporaries are not in the symbol table (nor
+ * are they declared by instructions); they are numbered from 1 and declared
+ * when the code is emitted.
+ */
+class Program
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  Program() = default;
+
+  /**
+   * Copy constructor
+   */
+  Program(const Program &) = default;
+
+  /**
+   * Move constructor
+   */
+  Program(Program &&) = default;
+
+  /**
+   * Destructor
+   */
+  ~Program() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  Program& operator=(const Program &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  Program& operator=(Program &&) = default;
+
+  /**
+   * Adds an instruction to the end of the program.
+   *
+   * @param theInstruction
+   *          instruction to add
+   */
+  void append(const Instruction &theInstruction);
+
+  /**
+   * Returns the program's instructions.
+   *
+   * @return instructions
+   */
+  std::vector<Instruction>& getInstructions() noexcept;
+
+  /**
+   * Returns the program's instructions.
+   *
+   * @return instructions
+   */
+  const std::vector<Instruction>& getInstructions() const noexcept;
+
+  /**
+   * Returns the source text for an operand (symbol name, temporary name or
+   * literal value).
+   *
+   * @param theOperand
+   *          operand
+   * @return operand text
+   */
+  std::string getName(const Operand &theOperand) const;
+
+  /**
+   * Returns the dense index of a symbol or temporary, for tables indexed by
+   * variable: the symbols in symbol table order, then the temporaries.
+   *
+   * @param theOperand
+   *          symbol or temporary
+   * @return index, less than getSlotCount()
+   */
+  uint32_t getSlot(const Operand &theOperand) const noexcept;
+
+  /**
+   * Returns the number of slots (see getSlot).
+   *
+   * @return number of symbols and temporaries
+   */
+  uint32_t getSlotCount() const noexcept;
+
+  /**
+   * Returns the program's symbols.
+   *
+   * @return symbol table
+   */
+  SymbolTable& getSymbolTable() noexcept;
+
+  /**
+   * Returns the program's symbols.
+   *
+   * @return symbol table
+   */
+  const SymbolTable& getSymbolTable() const noexcept;
+
+  /**
+   * Returns the highest temporary number in use (temporaries are numbered
+   * from 1).
+   *
+   * @return number of temporaries
+   */
+  uint32_t getTemporaryCount() const noexcept;
+
+  /**
+   * Allocates a new temporary.
+   *
+   * @return temporary operand
+   */
+  Operand newTemporary() noexcept;
+
+  /**
+   * Sets the highest temporary number in use (for passes which renumber
+   * temporaries).
+   *
+   * @param theCount
+   *          number of temporaries
+   */
+  void setTemporaryCount(uint32_t theCount) noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Instructions, in execution order. */
+  std::vector<Instruction> myInstructions;
+
+  /** Known symbols. */
+  SymbolTable mySymbolTable;
+
+  /** Highest temporary number. */
+  uint32_t myTemporaryCount = 0;
+};
+
+#endif
@@ -0,0 +1,309 @@
+/**
+ * @file Reassociation.cpp
+ * @brief Implementation of Reassociation class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <tuple>
+
+#include "AnalysisManager.h"
+#include "Program.h"
+#include "Reassociation.h"
+#include "SSAForm.h"
+#include "Statistics.h"
+
+//**************************************************
+// Reassociation::Reassociation
+//**************************************************
+Reassociation::Reassociation(bool thePreserveOrder) :
+  myPreserveOrder(thePreserveOrder)
+{
+}
+
+//**************************************************
+// Reassociation::balance
+//**************************************************
+Operand Reassociation::balance(Program &theProgram,
+                               std::vector<Operand> theOperands,
+                               std::vector<Instruction> &theCode)
+{
+  while (theOperands.size() > 1)
+  {
+    std::size_t sums = 0;
+    for (std::size_t ii = 0; ii < theOperands.size(); ii += 2)
+    {
+      if (ii + 1 < theOperands.size())
+      {
+        auto sum = theProgram.newTemporary();
+        theCode.emplace_back(Instruction::OpCode::Add, theOperands[ii],
+                             theOperands[ii + 1], sum);
+        theOperands[sums++] = sum;
+      }
+      else
+      {
+        theOperands[sums++] = theOperands[ii];
+      }
+    }
+    theOperands.resize(sums);
+  }
+  return theOperands[0];
+}
+
+//**************************************************
+// Reassociation::flatten
+//**************************************************
+uint32_t Reassociation::flatten(const Program &theProgram,
+                                const SSAForm &theSSA, uint32_t theRoot,
+                                int64_t &theConstant, uint32_t &theLiterals)
+{
+  auto &instructions = theProgram.getInstructions();
+  myTerms.clear();
+  myTermIndexes.clear();
+  uint64_t constant = 0;
+  theLiterals = 0;
+  uint32_t chain = 1;
+
+  // Source operands (instruction, operand) still to be flattened, with the
+  // sign they are added with.
+  std::vector<std::tuple<uint32_t, uint32_t, int64_t>> pending;
+  auto addSources = [&](uint32_t theInstruction, int64_t theSign)
+  {
+    auto isSub = (Instruction::OpCode::Sub ==
+                  instructions[theInstruction].getOpCode());
+    // Pushed right first so terms are seen left to right.
+    pending.emplace_back(theInstruction, 1, isSub ? -theSign : theSign);
+    pending.emplace_back(theInstruction, 0, theSign);
+  };
+  addSources(theRoot, 1);
+
+  while (! pending.empty())
+  {
+    uint32_t user;
+    uint32_t source;
+    int64_t sign;
+    std::tie(user, source, sign) = pending.back();
+    pending.pop_back();
+    auto operand = instructions[user].getOperand(source);
+
+    if (Operand::Kind::Literal == operand.getKind())
+    {
+      // Wraps, as the generated code would.
+      constant += static_cast<uint64_t>(sign) *
+        static_cast<uint64_t>(operand.getValue());
+      ++theLiterals;
+      continue;
+    }
+
+    auto value = theSSA.getValue(user, source);
+    if (Operand::Kind::Temporary == operand.getKind() &&
+        SSAForm::Kind::Instruction == theSSA.getKind(value) &&
+        1 == theSSA.getUseCount(value))
+    {
+      auto definition = theSSA.getInstruction(value);
+      auto &instruction = instructions[definition];
+      auto opCode = instruction.getOpCode();
+      // The sources of an absorbed instruction are read at the root
+      // instead, so must not be assigned in between.
+      bool movable = (Instruction::OpCode::Add == opCode ||
+                      Instruction::OpCode::Sub == opCode);
+      for (uint32_t input = 0; movable && input < 2; ++input)
+      {
+        auto &sourceOperand = instruction.getOperand(input);
+        movable = (Operand::Kind::Symbol != sourceOperand.getKind() ||
+                   ! isAssignedBetween(sourceOperand.getIndex(), definition,
+                                       theRoot));
+      }
+      if (movable)
+      {
+        myAbsorbed[definition] = true;
+        ++chain;
+        addSources(definition, sign);
+        continue;
+      }
+    }
+
+    auto key = (static_cast<uint64_t>(operand.getKind()) << 32) |
+      operand.getIndex();
+    auto term = myTermIndexes.find(key);
+    if (myTermIndexes.end() == term)
+    {
+      myTermIndexes.emplace(key, myTerms.size());
+      myTerms.push_back(Term{operand, sign, 1});
+    }
+    else
+    {
+      myTerms[term->second].myCoefficient += sign;
+      ++myTerms[term->second].myOccurrences;
+    }
+  }
+
+  theConstant = static_cast<int64_t>(constant);
+  return chain;
+}
+
+//**************************************************
+// Reassociation::getName
+//**************************************************
+const char* Reassociation::getName() const noexcept
+{
+  return "reassociation";
+}
+
+//**************************************************
+// Reassociation::isAssignedBetween
+//**************************************************
+bool Reassociation::isAssignedBetween(uint32_t theSymbol,
+                                      std::size_t theFirst,
+                                      std::size_t theLast) const noexcept
+{
+  auto &assignments = mySymbolAssignments[theSymbol];
+  auto next = std::upper_bound(assignments.begin(), assignments.end(),
+                               theFirst);
+  return next != assignments.end() && *next < theLast;
+}
+
+//**************************************************
+// Reassociation::run
+//**************************************************
+void Reassociation::run(Program &theProgram, AnalysisManager &theAnalyses,
+                        Statistics &theStatistics)
+{
+  setChanged(false);
+  if (myPreserveOrder)
+  {
+    return;
+  }
+
+  auto &instructions = theProgram.getInstructions();
+  const std::size_t none = instructions.size();
+  mySymbolAssignments.assign(theProgram.getSymbolTable().size(), {});
+  myAbsorbed.assign(instructions.size(), false);
+  auto &ssa = theAnalyses.getSSAForm(theProgram);
+
+  for (std::size_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    auto &instruction = instructions[ii];
+    if (instruction.hasDestination() &&
+        Operand::Kind::Symbol == instruction.getDestination().getKind())
+    {
+      mySymbolAssignments[instruction.getDestination().getIndex()]
+        .push_back(ii);
+    }
+  }
+
+  // Chains are found from their last instruction, so working backwards the
+  // next Add or Sub not already absorbed is always the root of a chain.
+  std::vector<std::size_t> replacementOf(instructions.size(), none);
+  std::vector<std::vector<Instruction>> replacements;
+  uint64_t chains = 0;
+  uint64_t cancelled = 0;
+  uint64_t merged = 0;
+
+  for (uint32_t root = instructions.size(); root-- > 0; )
+  {
+    auto opCode = instructions[root].getOpCode();
+    if (myAbsorbed[root] ||
+        (Instruction::OpCode::Add != opCode &&
+         Instruction::OpCode::Sub != opCode))
+    {
+      continue;
+    }
+
+    int64_t constant;
+    uint32_t literals;
+    if (flatten(theProgram, ssa, root, constant, literals) < 2)
+    {
+      continue;
+    }
+
+    std::vector<Operand> positive;
+    std::vector<Operand> negative;
+    for (auto &term : myTerms)
+    {
+      cancelled += term.myOccurrences - std::abs(term.myCoefficient);
+      auto &terms = (term.myCoefficient > 0) ? positive : negative;
+      for (auto count = std::abs(term.myCoefficient); count > 0; --count)
+      {
+        terms.push_back(term.myOperand);
+      }
+    }
+    if (0 != constant)
+    {
+      // -INT64_MIN wraps to itself, so it's added rather than subtracted.
+      if (constant > 0 || INT64_MIN == constant)
+      {
+        positive.emplace_back(Operand::Kind::Literal, constant);
+      }
+      else
+      {
+        negative.emplace_back(Operand::Kind::Literal, -constant);
+      }
+    }
+    if (literals > 1)
+    {
+      merged += literals - (0 != constant ? 1 : 0);
+    }
+
+    auto destination = instructions[root].getDestination();
+    std::vector<Instruction> code;
+    if (positive.empty() && negative.empty())
+    {
+      code.emplace_back(Instruction::OpCode::Store,
+                        Operand(Operand::Kind::Literal, 0), destination);
+    }
+    else if (negative.empty())
+    {
+      auto sum = balance(theProgram, std::move(positive), code);
+      if (! code.empty() && code.back().getDestination() == sum)
+      {
+        code.back().setDestination(destination);
+      }
+      else
+      {
+        code.emplace_back(Instruction::OpCode::Store, sum, destination);
+      }
+    }
+    else
+    {
+      auto minuend = positive.empty() ?
+        Operand(Operand::Kind::Literal, 0) :
+        balance(theProgram, std::move(positive), code);
+      auto subtrahend = balance(theProgram, std::move(negative), code);
+      code.emplace_back(Instruction::OpCode::Sub, minuend, subtrahend,
+                        destination);
+    }
+
+    for (auto &instruction : code)
+    {
+      instruction.setLine(instructions[root].getLine());
+    }
+    replacementOf[root] = replacements.size();
+    replacements.push_back(std::move(code));
+    ++chains;
+  }
+
+  std::vector<Instruction> code;
+  code.reserve(instructions.size());
+  for (std::size_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    if (none != replacementOf[ii])
+    {
+      auto &replacement = replacements[replacementOf[ii]];
+      code.insert(code.end(), replacement.begin(), replacement.end());
+    }
+    else if (! myAbsorbed[ii])
+    {
+      code.push_back(instructions[ii]);
+    }
+  }
+  instructions.swap(code);
+  setChanged(0 != chains);
+
+  theStatistics.add("chains reassociated", chains);
+  theStatistics.add("terms cancelled", cancelled);
+  theStatistics.add("literals merged", merged);
+}
@@ -0,0 +1,154 @@
+#ifndef REASSOCIATION_H
+#define REASSOCIATION_H
+
+/**
+ * @file Reassociation.h
+ * @brief Defines the pass which reassociates chains of additions and
+ * subtractions.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Instruction.h"
+#include "Operand.h"
+#include "Pass.h"
+
+class SSAForm;
+
+/**
+ * Reassociation of +/- chains. A chain is an Add or Sub together with every
+ * Add or Sub computing a temporary read only by the chain. Each chain is
+ * flattened into a sum of signed terms in which matching terms cancel
+ * (x - x) and literals are merged into one constant. The terms are then
+ * summed pairwise, positive and negative terms separately, so a chain of n
+ * terms has a dependency depth of log2(n) rather than n.
+ *
+ * Arithmetic wraps, so the result is always the same, but intermediate
+ * values (and therefore which operation, if any, overflows) change. When
+ * evaluation order is to be preserved the pass does nothing.
+ *
+ * Relies on temporaries being assigned only once, so it must run before
+ * temporary allocation.
+ */
+class Reassociation : public Pass
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  Reassociation() = delete;
+
+  /**
+   * Constructor
+   *
+   * @param thePreserveOrder
+   *          leave evaluation order unchanged (i.e., do nothing)
+   */
+  explicit Reassociation(bool thePreserveOrder);
+
+  /**
+   * Destructor
+   */
+  virtual ~Reassociation() = default;
+
+  virtual const char* getName() const noexcept override;
+
+  virtual void run(Program &theProgram, AnalysisManager &theAnalyses,
+                   Statistics &theStatistics) override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** A term of a flattened chain. */
+  struct Term
+  {
+    /** Symbol or temporary. */
+    Operand myOperand;
+
+    /** Number of times the operand is added (negative if subtracted). */
+    int64_t myCoefficient;
+
+    /** Number of times the operand appears in the chain. */
+    uint32_t myOccurrences;
+  };
+
+  /**
+   * Emits code summing the given operands, pairwise.
+   *
+   * @param theProgram
+   *          program (for new temporaries)
+   * @param theOperands
+   *          operands to sum (not empty)
+   * @param theCode
+   *          code to append to
+   * @return operand holding the sum
+   */
+  static Operand balance(Program &theProgram, std::vector<Operand> theOperands,
+                         std::vector<Instruction> &theCode);
+
+  /**
+   * Flattens the chain rooted at an instruction into terms, marking the
+   * instructions absorbed into it.
+   *
+   * @param theProgram
+   *          program being transformed
+   * @param theSSA
+   *          SSA form of the program
+   * @param theRoot
+   *          index of the root instruction
+   * @param theConstant
+   *          sum of the literal terms
+   * @param theLiterals
+   *          number of literal terms
+   * @return number of instructions in the chain
+   */
+  uint32_t flatten(const Program &theProgram, const SSAForm &theSSA,
+                   uint32_t theRoot, int64_t &theConstant,
+                   uint32_t &theLiterals);
+
+  /**
+   * Returns if a symbol is assigned between two instructions (exclusive).
+   *
+   * @param theSymbol
+   *          symbol index
+   * @param theFirst
+   *          index of the first instruction
+   * @param theLast
+   *          index of the last instruction
+   * @return true if assigned
+   */
+  bool isAssignedBetween(uint32_t theSymbol, std::size_t theFirst,
+                         std::size_t theLast) const noexcept;
+
+  /** Has each instruction been absorbed into a later chain? */
+  std::vector<bool> myAbsorbed;
+
+  /** Leave evaluation order unchanged? */
+  bool myPreserveOrder;
+
+  /** Indexes of the instructions assigning each symbol, ascending. */
+  std::vector<std::vector<std::size_t>> mySymbolAssignments;
+
+  /** Index into myTerms of each operand, keyed by kind and index. */
+  std::unordered_map<uint64_t, std::size_t> myTermIndexes;
+
+  /** Terms of the chain being flattened, in order of first appearance. */
+  std::vector<Term> myTerms;
+};
+
+#endif
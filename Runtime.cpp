@@ -0,0 +1,474 @@
+/**
+ * @file Runtime.cpp
+ * @brief Implementation of the runtime support routines
+ *
+ * @author Michael Albers
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <signal.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "Runtime.h"
+
+/** Size of the input and output buffers. */
+static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+/** Input not yet parsed is micro_input[micro_inputPosition, Length). */
+static char micro_input[BUFFER_SIZE];
+static std::size_t micro_inputPosition = 0;
+static std::size_t micro_inputLength = 0;
+
+/** Output not yet written is micro_output[0, Length). */
+static char micro_output[BUFFER_SIZE];
+static std::size_t micro_outputLength = 0;
+
+/** Has micro_flush been registered to run at exit? */
+static bool micro_flushAtExit = false;
+
+/** Overflow traps of the checked code running (see micro_trap_overflows). */
+static const char *micro_trapCode = nullptr;
+static const uint32_t *micro_traps = nullptr;
+static uint32_t micro_trapCount = 0;
+static void (*micro_trapOverflow)(uint32_t) = nullptr;
+
+/** "00" to "99", for formatting two digits at a time. */
+static const char DIGIT_PAIRS[] =
+  "00010203040506070809101112131415161718192021222324252627282930313233"
+  "34353637383940414243444546474849505152535455565758596061626364656667"
+  "6869707172737475767778798081828384858687888990919293949596979899";
+
+//**************************************************
+// micro_fail
+//**************************************************
+[[noreturn]] static void micro_fail()
+{
+  micro_flush();
+  std::fputs("error: expected an integer on input\n", stderr);
+  std::exit(1);
+}
+
+//**************************************************
+// micro_fill
+//**************************************************
+static bool micro_fill()
+{
+  // Unparsed bytes are kept, so a number is never split between reads.
+  auto kept = micro_inputLength - micro_inputPosition;
+  std::memmove(micro_input, micro_input + micro_inputPosition, kept);
+  micro_inputPosition = 0;
+  micro_inputLength = kept;
+
+  ssize_t count;
+  do
+  {
+    count = ::read(STDIN_FILENO, micro_input + kept, BUFFER_SIZE - kept);
+  } while (count < 0 && EINTR == errno);
+  if (count <= 0)
+  {
+    return false;
+  }
+  micro_inputLength += count;
+  return true;
+}
+
+//**************************************************
+// micro_next
+//**************************************************
+static int micro_next()
+{
+  if (micro_inputPosition == micro_inputLength && ! micro_fill())
+  {
+    return EOF;
+  }
+  return static_cast<unsigned char>(micro_input[micro_inputPosition++]);
+}
+
+//**************************************************
+// micro_trap
+//**************************************************
+static void micro_trap(int, siginfo_t*, void *theContext)
+{
+#ifdef __x86_64__
+  auto &registers = static_cast<ucontext_t*>(theContext)->uc_mcontext.gregs;
+  auto address = reinterpret_cast<const char*>(registers[REG_RIP]);
+  if (address >= micro_trapCode && address - micro_trapCode <= UINT32_MAX)
+  {
+    // The traps are in order of offset.
+    auto offset = static_cast<uint32_t>(address - micro_trapCode);
+    uint32_t low = 0;
+    uint32_t high = micro_trapCount;
+    while (low < high)
+    {
+      auto middle = low + (high - low) / 2;
+      if (micro_traps[2 * middle] < offset)
+      {
+        low = middle + 1;
+      }
+      else
+      {
+        high = middle;
+      }
+    }
+    if (low < micro_trapCount && offset == micro_traps[2 * low])
+    {
+      // Resume in the overflow routine, as if the trap had called it.
+      registers[REG_RSP] -= sizeof(greg_t);
+      *reinterpret_cast<greg_t*>(registers[REG_RSP]) = registers[REG_RIP];
+      registers[REG_RDI] = micro_traps[2 * low + 1];
+      registers[REG_RIP] = reinterpret_cast<greg_t>(micro_trapOverflow);
+      return;
+    }
+  }
+#else
+  (void)theContext;
+#endif
+  // Not an overflow trap: the instruction faults again, and stops the
+  // program as it would have.
+  std::signal(SIGILL, SIG_DFL);
+}
+
+//**************************************************
+// micro_flush
+//**************************************************
+void micro_flush()
+{
+  // Anything the host wrote with stdio goes first.
+  std::fflush(stdout);
+
+  std::size_t written = 0;
+  while (written < micro_outputLength)
+  {
+    auto count = ::write(STDOUT_FILENO, micro_output + written,
+                         micro_outputLength - written);
+    if (count < 0 && EINTR == errno)
+    {
+      continue;
+    }
+    if (count <= 0)
+    {
+      break;
+    }
+    written += count;
+  }
+  micro_outputLength = 0;
+}
+
+//**************************************************
+// micro_format
+//**************************************************
+char* micro_format(int64_t theValue, char *theEnd)
+{
+  char *first = theEnd;
+  uint64_t magnitude = (theValue < 0) ?
+    0 - static_cast<uint64_t>(theValue) : static_cast<uint64_t>(theValue);
+  while (magnitude >= 100)
+  {
+    auto pair = 2 * (magnitude % 100);
+    magnitude /= 100;
+    *--first = DIGIT_PAIRS[pair + 1];
+    *--first = DIGIT_PAIRS[pair];
+  }
+  if (magnitude >= 10)
+  {
+    *--first = DIGIT_PAIRS[2 * magnitude + 1];
+    *--first = DIGIT_PAIRS[2 * magnitude];
+  }
+  else
+  {
+    *--first = '0' + magnitude;
+  }
+  if (theValue < 0)
+  {
+    *--first = '-';
+  }
+  return first;
+}
+
+//**************************************************
+// micro_overflow
+//**************************************************
+void micro_overflow(uint32_t theLine)
+{
+  micro_flush();
+  std::fprintf(stderr, "error: integer overflow on line %u\n", theLine);
+  std::exit(1);
+}
+
+//**************************************************
+// micro_parse_digits
+//**************************************************
+const char* micro_parse_digits(const char *theFirst, const char *theLast,
+                               uint64_t *theValue)
+{
+  auto value = *theValue;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // Eight digits at a time (SWAR) while eight remain.
+  while (theLast - theFirst >= 8)
+  {
+    uint64_t chunk;
+    std::memcpy(&chunk, theFirst, 8);
+    // Every byte is 0x30 to 0x39 (adding 6 doesn't carry out of 0x3F).
+    if (0 != (((chunk & 0xF0F0F0F0F0F0F0F0ull) |
+               (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >>
+                4)) ^ 0x3333333333333333ull))
+    {
+      break;
+    }
+    chunk -= 0x3030303030303030ull;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+             (((chunk >> 16) & 0x000000FF000000FFull) *
+              (1 + (10000ull << 32)))) >> 32;
+    value = value * 100000000 + chunk;
+    theFirst += 8;
+  }
+#endif
+  for (; theFirst != theLast && *theFirst >= '0' && *theFirst <= '9';
+       ++theFirst)
+  {
+    value = value * 10 + (*theFirst - '0');
+  }
+  *theValue = value;
+  return theFirst;
+}
+
+//**************************************************
+// micro_power
+//**************************************************
+int64_t micro_power(int64_t theBase, int64_t theExponent)
+{
+  if (theExponent < 0)
+  {
+    if (1 == theBase || -1 == theBase)
+    {
+      return (theExponent & 1) ? theBase : 1;
+    }
+    return 0;
+  }
+
+  // Square and multiply, in unsigned arithmetic so overflow wraps.
+  uint64_t result = 1;
+  uint64_t square = theBase;
+  for (uint64_t exponent = theExponent; exponent != 0; exponent >>= 1)
+  {
+    if (exponent & 1)
+    {
+      result *= square;
+    }
+    square *= square;
+  }
+  return static_cast<int64_t>(result);
+}
+
+//**************************************************
+// micro_power_checked
+//**************************************************
+int64_t micro_power_checked(int64_t theBase, int64_t theExponent,
+                            uint32_t theLine)
+{
+  if (theExponent < 0)
+  {
+    // 1 / 0 ** -theExponent divides by zero.
+    if (0 == theBase)
+    {
+      micro_flush();
+      std::fprintf(stderr, "error: zero to a negative power on line %u\n",
+                   theLine);
+      std::exit(1);
+    }
+    return micro_power(theBase, theExponent);
+  }
+
+  // Every partial result and square is a power of the base no greater than
+  // the result, so one overflows only if the result does. The square is
+  // only taken while exponent bits remain.
+  int64_t result = 1;
+  int64_t square = theBase;
+  for (uint64_t exponent = theExponent; exponent != 0; )
+  {
+    if ((exponent & 1) && __builtin_mul_overflow(result, square, &result))
+    {
+      micro_overflow(theLine);
+    }
+    exponent >>= 1;
+    if (exponent != 0 && __builtin_mul_overflow(square, square, &square))
+    {
+      micro_overflow(theLine);
+    }
+  }
+  return result;
+}
+
+//**************************************************
+// micro_profile_write
+//**************************************************
+void micro_profile_write(const char *theSource, const uint32_t *theLines,
+                         uint64_t *theCounts, uint64_t *theCycles,
+                         uint32_t theCount)
+{
+  const char *file = std::getenv("MICRO_PROFILE");
+  if (nullptr == file || '\0' == *file)
+  {
+    file = "micro.prof";
+  }
+  std::string header = std::string("# profile of ") + theSource + "\n" +
+    (nullptr == theCycles ? "# line runs\n" : "# line runs cycles\n");
+
+  // An earlier profile is only added in if it's of the same program.
+  if (auto *previous = std::fopen(file, "r"))
+  {
+    std::string text;
+    char buffer[4096];
+    for (auto count = std::fread(buffer, 1, sizeof(buffer), previous);
+         count > 0; count = std::fread(buffer, 1, sizeof(buffer), previous))
+    {
+      text.append(buffer, count);
+    }
+    std::fclose(previous);
+
+    std::vector<uint64_t> counts(theCount, 0);
+    std::vector<uint64_t> cycles(theCount, 0);
+    bool same = (0 == text.compare(0, header.size(), header));
+    auto *position = text.c_str() + (same ? header.size() : 0);
+    for (uint32_t ii = 0; same && ii < theCount; ++ii)
+    {
+      char *end;
+      same = (std::strtoull(position, &end, 10) == theLines[ii] &&
+              end != position);
+      position = end;
+      counts[ii] = std::strtoull(position, &end, 10);
+      same = same && end != position;
+      position = end;
+      if (nullptr != theCycles)
+      {
+        cycles[ii] = std::strtoull(position, &end, 10);
+        same = same && end != position;
+        position = end;
+      }
+    }
+    for (uint32_t ii = 0; same && ii < theCount; ++ii)
+    {
+      theCounts[ii] += counts[ii];
+      if (nullptr != theCycles)
+      {
+        theCycles[ii] += cycles[ii];
+      }
+    }
+  }
+
+  auto *profile = std::fopen(file, "w");
+  if (nullptr == profile)
+  {
+    std::fprintf(stderr, "warning: failed to write profile '%s': %s\n", file,
+                 std::strerror(errno));
+    return;
+  }
+  std::fputs(header.c_str(), profile);
+  for (uint32_t ii = 0; ii < theCount; ++ii)
+  {
+    if (nullptr == theCycles)
+    {
+      std::fprintf(profile, "%u %llu\n", theLines[ii],
+                   static_cast<unsigned long long>(theCounts[ii]));
+    }
+    else
+    {
+      std::fprintf(profile, "%u %llu %llu\n", theLines[ii],
+                   static_cast<unsigned long long>(theCounts[ii]),
+                   static_cast<unsigned long long>(theCycles[ii]));
+    }
+  }
+  std::fclose(profile);
+}
+
+//**************************************************
+// micro_read
+//**************************************************
+int64_t micro_read()
+{
+  int c;
+  do
+  {
+    c = micro_next();
+  } while (' ' == c || '\t' == c || '\n' == c || '\r' == c || '\v' == c ||
+           '\f' == c);
+
+  bool negative = ('-' == c);
+  if ('-' == c || '+' == c)
+  {
+    c = micro_next();
+  }
+  if (c < '0' || c > '9')
+  {
+    micro_fail();
+  }
+
+  // Overflow wraps, as in arithmetic. The digits may run past the buffer.
+  uint64_t value = c - '0';
+  do
+  {
+    auto end = micro_parse_digits(micro_input + micro_inputPosition,
+                                  micro_input + micro_inputLength, &value);
+    micro_inputPosition = end - micro_input;
+  } while (micro_inputPosition == micro_inputLength && micro_fill());
+  return static_cast<int64_t>(negative ? 0 - value : value);
+}
+
+//**************************************************
+// micro_trap_overflows
+//**************************************************
+void micro_trap_overflows(const void *theCode, const uint32_t *theTraps,
+                          uint32_t theCount, void (*theOverflow)(uint32_t))
+{
+  micro_trapCode = static_cast<const char*>(theCode);
+  micro_traps = theTraps;
+  micro_trapCount = theCount;
+  micro_trapOverflow = theOverflow;
+
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  sigemptyset(&action.sa_mask);
+  if (0 == theCount)
+  {
+    action.sa_handler = SIG_DFL;
+  }
+  else
+  {
+    action.sa_sigaction = micro_trap;
+    action.sa_flags = SA_SIGINFO;
+  }
+  ::sigaction(SIGILL, &action, nullptr);
+}
+
+//**************************************************
+// micro_write
+//**************************************************
+void micro_write(int64_t theValue)
+{
+  if (! micro_flushAtExit)
+  {
+    std::atexit(micro_flush);
+    micro_flushAtExit = true;
+  }
+  // Room for a sign, 19 digits and a newline.
+  if (micro_outputLength + 21 > BUFFER_SIZE)
+  {
+    micro_flush();
+  }
+
+  char text[20];
+  auto first = micro_format(theValue, text + sizeof(text));
+  auto length = text + sizeof(text) - first;
+  std::memcpy(micro_output + micro_outputLength, first, length);
+  micro_outputLength += length;
+  micro_output[micro_outputLength++] = '\n';
+}
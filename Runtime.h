@@ -0,0 +1,171 @@
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+/**
+ * @file Runtime.h
+ * @brief Declares the runtime support routines called by compiled programs.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+
+/*
+ * Native code (see X86Backend) calls these for the instructions it doesn't
+ * implement inline. They are built into libMicroRuntime.a, which compiled
+ * programs are linked with, and use the C calling convention so generated
+ * code needn't know about C++ name mangling. The JIT and the interpreter
+ * use them too.
+ *
+ * Input is whitespace separated decimal integers; output is one integer
+ * per line. A program which tries to read past the end of its input, or
+ * reads something not an integer, is stopped with an error.
+ *
+ * Input is read in 64 KiB blocks and parsed eight digits at a time where
+ * possible. Output is formatted two digits at a time into a 64 KiB buffer,
+ * written with one system call when full and at exit (or by micro_flush).
+ * Integers too large for 64 bits wrap, as arithmetic does. The batch
+ * interpreter (BatchMachine) parses and formats its fields with
+ * micro_parse_digits and micro_format, and the C backend emits C versions
+ * of micro_read and micro_write with the same rules, so every backend
+ * reads and writes the same.
+ *
+ * Checked code (--checked) reports a signed overflow with micro_overflow,
+ * which stops the program with the line of the statement that overflowed.
+ * Native and JIT code don't call it, but trap (ud2) after an add, sub or
+ * imul which overflowed; micro_trap_overflows is given a table of the
+ * traps and turns one into a call of micro_overflow with its line. Checked
+ * code is then 4 bytes an operation larger, and has no code for reporting
+ * lines (the table is data, read only on overflow).
+ */
+extern "C"
+{
+  /**
+   * Implements Read: reads the next integer from stdin.
+   *
+   * @return integer read
+   */
+  int64_t micro_read();
+
+  /**
+   * Implements Write: writes an integer to stdout.
+   *
+   * @param theValue
+   *          integer to write
+   */
+  void micro_write(int64_t theValue);
+
+  /**
+   * Writes any buffered output to stdout (after anything buffered by
+   * stdio).
+   */
+  void micro_flush();
+
+  /**
+   * Formats an integer in decimal, two digits at a time.
+   *
+   * @param theValue
+   *          integer to format
+   * @param theEnd
+   *          end of the text, with room for 20 characters before it
+   * @return first character of the text
+   */
+  char* micro_format(int64_t theValue, char *theEnd);
+
+  /**
+   * Continues parsing a decimal integer, eight digits at a time where
+   * possible.
+   *
+   * @param theFirst
+   *          first character to parse
+   * @param theLast
+   *          end of the characters to parse
+   * @param theValue
+   *          value of the digits so far, updated with each digit parsed
+   *          (wrapping)
+   * @return first character which isn't a digit, or theLast
+   */
+  const char* micro_parse_digits(const char *theFirst, const char *theLast,
+                                 uint64_t *theValue);
+
+  /**
+   * Implements Pow, with the same semantics as OperatorRecord::power (the
+   * result wraps on overflow).
+   *
+   * @param theBase
+   *          base
+   * @param theExponent
+   *          exponent
+   * @return theBase ** theExponent
+   */
+  int64_t micro_power(int64_t theBase, int64_t theExponent);
+
+  /**
+   * Implements checked Pow: as micro_power, but an overflow stops the
+   * program (see micro_overflow), and so does 0 to a negative power, which
+   * divides by zero.
+   *
+   * @param theBase
+   *          base
+   * @param theExponent
+   *          exponent
+   * @param theLine
+   *          source line of the Pow
+   * @return theBase ** theExponent
+   */
+  int64_t micro_power_checked(int64_t theBase, int64_t theExponent,
+                              uint32_t theLine);
+
+  /**
+   * Stops the program on a signed overflow in checked code: flushes
+   * output, reports the line on stderr and exits with status 1.
+   *
+   * @param theLine
+   *          source line of the instruction which overflowed
+   */
+  [[noreturn]] void micro_overflow(uint32_t theLine);
+
+  /**
+   * Makes the overflow traps of checked native or JIT code report their
+   * lines: a ud2 at one of the traps (SIGILL) resumes in an overflow
+   * routine, as if it had called it with the trap's line. Any other SIGILL
+   * stops the program as usual. (x86-64 only.)
+   *
+   * @param theCode
+   *          start of the code
+   * @param theTraps
+   *          pairs of a ud2's offset from theCode and its source line, in
+   *          order of offset
+   * @param theCount
+   *          number of traps; 0 removes the handler
+   * @param theOverflow
+   *          overflow routine (e.g., micro_overflow)
+   */
+  void micro_trap_overflows(const void *theCode, const uint32_t *theTraps,
+                            uint32_t theCount, void (*theOverflow)(uint32_t));
+
+  /**
+   * Writes the profile of an instrumented program (--instrument) to the
+   * file named by $MICRO_PROFILE, or micro.prof: a line per source line,
+   * with the number of times it ran and the time stamp counter cycles
+   * spent in it. A profile left by an earlier run of the same program is
+   * added in, so the file accumulates over runs.
+   *
+   * @param theSource
+   *          source file of the program
+   * @param theLines
+   *          source lines, in the order of their first code
+   * @param theCounts
+   *          runs of each line (added to by earlier runs)
+   * @param theCycles
+   *          cycles in each line (added to by earlier runs), or nullptr if
+   *          not timed
+   * @param theCount
+   *          number of lines
+   */
+  void micro_profile_write(const char *theSource, const uint32_t *theLines,
+                           uint64_t *theCounts, uint64_t *theCycles,
+                           uint32_t theCount);
+}
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ * @file SSAForm.cpp
+ * @brief Implementation of SSAForm class
+ *
+ * @author Michael Albers
+ */
+
+#include "Program.h"
+#include "SSAForm.h"
+
+constexpr uint32_t SSAForm::NO_VALUE;
+
+//**************************************************
+// SSAForm::SSAForm
+//**************************************************
+SSAForm::SSAForm(const Program &theProgram)
+{
+  auto &instructions = theProgram.getInstructions();
+  myDefinitions.assign(instructions.size(), NO_VALUE);
+  myOperandValues.assign(instructions.size() * MAX_SOURCES, NO_VALUE);
+
+  // Current value of each variable (symbols first, then temporaries).
+  std::vector<uint32_t> current(theProgram.getSlotCount(), NO_VALUE);
+  auto newValue = [&](Kind theKind, uint32_t theInstruction,
+                      const Operand &theVariable) -> uint32_t
+  {
+    myValues.push_back(Value{theKind, theInstruction, 0, theVariable});
+    return myValues.size() - 1;
+  };
+
+  for (uint32_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    auto &instruction = instructions[ii];
+    for (uint32_t source = 0; source < instruction.getSourceCount(); ++source)
+    {
+      auto &operand = instruction.getOperand(source);
+      if (! operand.isVariable())
+      {
+        continue;
+      }
+
+      auto &value = current[theProgram.getSlot(operand)];
+      if (NO_VALUE == value)
+      {
+        value = newValue(Kind::Entry, 0, operand);
+      }
+      myOperandValues[ii * MAX_SOURCES + source] = value;
+    }
+
+    if (instruction.hasDestination())
+    {
+      auto &destination = instruction.getDestination();
+      auto value = newValue(Kind::Instruction, ii, destination);
+      current[theProgram.getSlot(destination)] = value;
+      myDefinitions[ii] = value;
+    }
+  }
+
+  // Def-use chains, in instruction order within each value.
+  myUseOffsets.assign(myValues.size() + 1, 0);
+  for (auto value : myOperandValues)
+  {
+    if (NO_VALUE != value)
+    {
+      ++myUseOffsets[value + 1];
+    }
+  }
+  for (uint32_t value = 0; value < myValues.size(); ++value)
+  {
+    myUseOffsets[value + 1] += myUseOffsets[value];
+  }
+  myUses.resize(myUseOffsets.back());
+  std::vector<uint32_t> next(myUseOffsets.begin(), myUseOffsets.end() - 1);
+  for (uint32_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    for (uint32_t source = 0; source < MAX_SOURCES; ++source)
+    {
+      auto value = myOperandValues[ii * MAX_SOURCES + source];
+      if (NO_VALUE != value)
+      {
+        myUses[next[value]++] = Use{ii, source};
+      }
+    }
+  }
+}
+
+//**************************************************
+// SSAForm::getDefinition
+//**************************************************
+uint32_t SSAForm::getDefinition(uint32_t theInstruction) const noexcept
+{
+  return myDefinitions[theInstruction];
+}
+
+//**************************************************
+// SSAForm::getInstruction
+//**************************************************
+uint32_t SSAForm::getInstruction(uint32_t theValue) const noexcept
+{
+  return myValues[theValue].myInstruction;
+}
+
+//**************************************************
+// SSAForm::getKind
+//**************************************************
+SSAForm::Kind SSAForm::getKind(uint32_t theValue) const noexcept
+{
+  return myValues[theValue].myKind;
+}
+
+//**************************************************
+// SSAForm::getPhiOperands
+//**************************************************
+const std::vector<uint32_t>& SSAForm::getPhiOperands(uint32_t theValue)
+  const noexcept
+{
+  static const std::vector<uint32_t> none;
+  auto &value = myValues[theValue];
+  return (Kind::Phi == value.myKind) ? myPhiOperands[value.myPhi] : none;
+}
+
+//**************************************************
+// SSAForm::getUse
+//**************************************************
+const SSAForm::Use& SSAForm::getUse(uint32_t theValue,
+                                    uint32_t theIndex) const noexcept
+{
+  return myUses[myUseOffsets[theValue] + theIndex];
+}
+
+//**************************************************
+// SSAForm::getUseCount
+//**************************************************
+uint32_t SSAForm::getUseCount(uint32_t theValue) const noexcept
+{
+  return myUseOffsets[theValue + 1] - myUseOffsets[theValue];
+}
+
+//**************************************************
+// SSAForm::getValue
+//**************************************************
+uint32_t SSAForm::getValue(uint32_t theInstruction,
+                           uint32_t theOperand) const noexcept
+{
+  return myOperandValues[theInstruction * MAX_SOURCES + theOperand];
+}
+
+//**************************************************
+// SSAForm::getValueCount
+//**************************************************
+uint32_t SSAForm::getValueCount() const noexcept
+{
+  return myValues.size();
+}
+
+//**************************************************
+// SSAForm::getVariable
+//**************************************************
+const Operand& SSAForm::getVariable(uint32_t theValue) const noexcept
+{
+  return myValues[theValue].myVariable;
+}
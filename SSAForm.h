@@ -0,0 +1,236 @@
+#ifndef SSAFORM_H
+#define SSAFORM_H
+
+/**
+ * @file SSAForm.h
+ * @brief Defines the static single assignment view of a program.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "Operand.h"
+
+class Program;
+
+/**
+ * Static single assignment form of a program, kept as an index over its
+ * instructions rather than by renaming variables (the code still names
+ * symbols and temporaries, which the backends need).
+ *
+ * Every assignment (Read, Store, Add, ...) defines a new value. Every source
+ * operand naming a variable uses exactly one value, the one reaching it.
+ * Def-use chains link each value to all of its uses, so a pass can find the
+ * readers of a result, or that there are none, without rescanning the code.
+ *
+ * A variable read before it is assigned uses an entry value (the initial
+ * contents of the variable). The program is straight-line code, a single
+ * basic block, so renaming needs only the current value of each variable;
+ * with control flow this becomes the usual walk of the dominator tree, with
+ * phi values (which already have a kind and operand list here) placed at
+ * join points.
+ *
+ * The form is a snapshot: it must be rebuilt after the program is changed.
+ */
+class SSAForm
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** Value number of no value (e.g., a literal operand). */
+  static constexpr uint32_t NO_VALUE = UINT32_MAX;
+
+  /** Where a value is defined. */
+  enum class Kind : uint8_t
+  {
+    Entry,
+    Instruction,
+    Phi
+  };
+
+  /** A use of a value: a source operand of an instruction. */
+  struct Use
+  {
+    /** Index of the instruction. */
+    uint32_t myInstruction;
+
+    /** Index of the operand within the instruction. */
+    uint32_t myOperand;
+  };
+
+  /**
+   * Default constructor.
+   */
+  SSAForm() = delete;
+
+  /**
+   * Constructor. Builds the form of a program.
+   *
+   * @param theProgram
+   *          program
+   */
+  explicit SSAForm(const Program &theProgram);
+
+  /**
+   * Copy constructor
+   */
+  SSAForm(const SSAForm &) = default;
+
+  /**
+   * Move constructor
+   */
+  SSAForm(SSAForm &&) = default;
+
+  /**
+   * Destructor
+   */
+  ~SSAForm() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  SSAForm& operator=(const SSAForm &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  SSAForm& operator=(SSAForm &&) = default;
+
+  /**
+   * Returns the value defined by an instruction.
+   *
+   * @param theInstruction
+   *          instruction index
+   * @return value number, or NO_VALUE if the instruction assigns nothing
+   */
+  uint32_t getDefinition(uint32_t theInstruction) const noexcept;
+
+  /**
+   * Returns the index of the instruction defining a value.
+   *
+   * @param theValue
+   *          value number
+   * @return instruction index (only valid for Kind::Instruction)
+   */
+  uint32_t getInstruction(uint32_t theValue) const noexcept;
+
+  /**
+   * Returns where a value is defined.
+   *
+   * @param theValue
+   *          value number
+   * @return definition kind
+   */
+  Kind getKind(uint32_t theValue) const noexcept;
+
+  /**
+   * Returns the values merged by a phi value.
+   *
+   * @param theValue
+   *          value number
+   * @return incoming values (empty unless Kind::Phi)
+   */
+  const std::vector<uint32_t>& getPhiOperands(uint32_t theValue)
+    const noexcept;
+
+  /**
+   * Returns one use of a value.
+   *
+   * @param theValue
+   *          value number
+   * @param theIndex
+   *          use index, less than getUseCount
+   * @return use
+   */
+  const Use& getUse(uint32_t theValue, uint32_t theIndex) const noexcept;
+
+  /**
+   * Returns the number of uses of a value.
+   *
+   * @param theValue
+   *          value number
+   * @return number of uses
+   */
+  uint32_t getUseCount(uint32_t theValue) const noexcept;
+
+  /**
+   * Returns the value read by a source operand.
+   *
+   * @param theInstruction
+   *          instruction index
+   * @param theOperand
+   *          source operand index
+   * @return value number, or NO_VALUE for a literal
+   */
+  uint32_t getValue(uint32_t theInstruction, uint32_t theOperand)
+    const noexcept;
+
+  /**
+   * Returns the number of values.
+   *
+   * @return number of values
+   */
+  uint32_t getValueCount() const noexcept;
+
+  /**
+   * Returns the variable a value is assigned to.
+   *
+   * @param theValue
+   *          value number
+   * @return symbol or temporary
+   */
+  const Operand& getVariable(uint32_t theValue) const noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Maximum number of source operands of any instruction. */
+  static constexpr uint32_t MAX_SOURCES = 2;
+
+  /** A value. */
+  struct Value
+  {
+    /** Where the value is defined. */
+    Kind myKind;
+
+    /** Defining instruction (Kind::Instruction). */
+    uint32_t myInstruction;
+
+    /** Index into myPhiOperands (Kind::Phi). */
+    uint32_t myPhi;
+
+    /** Variable assigned. */
+    Operand myVariable;
+  };
+
+  /** Value defined by each instruction. */
+  std::vector<uint32_t> myDefinitions;
+
+  /** Values read by the source operands, MAX_SOURCES per instruction. */
+  std::vector<uint32_t> myOperandValues;
+
+  /** Incoming values of each phi. */
+  std::vector<std::vector<uint32_t>> myPhiOperands;
+
+  /** Uses, grouped by value. */
+  std::vector<Use> myUses;
+
+  /** Start of each value's uses in myUses (one extra entry at the end). */
+  std::vector<uint32_t> myUseOffsets;
+
+  /** All values. */
+  std::vector<Value> myValues;
+};
+
+#endif
@@ -83,13 +83,14 @@ Token Scanner::getCurrentToken() const
 // Scanner::idOrReserved
 //**********************
 Token Scanner::idOrReserved(const std::string &theTokenLiteral,
+                            uint64_t theTokenHash,
                             uint32_t theTokenStartColumn)
 {
   std::string token {theTokenLiteral};
   std::transform(token.begin(), token.end(), token.begin(), ::tolower);
 
-  Token idOrReserved(
-    Token::Type::Id, theTokenLiteral, myLine, theTokenStartColumn);
+  Token idOrReserved(Token::Type::Id, theTokenLiteral, theTokenHash,
+                     myLine, theTokenStartColumn);
 
   auto reservedIter = ourReservedWords.find(token);
   if (reservedIter != ourReservedWords.end())
@@ -125,7 +126,10 @@ Token Scanner::nextToken()
 {
   myCurrentToken = peek();
   myPeekToken = readToken();
-  myTokens.erase(myTokens.begin()); // TODO: assignment 3 code
+  if (! myTokens.empty())
+  {
+    myTokens.pop_front(); // TODO: assignment 3 code
+  }
   return myCurrentToken;
 }
 
@@ -183,18 +187,22 @@ Token Scanner::readToken()
       }
       else if (std::isalpha(currentChar))
       {
+        // Identifiers are hashed as they are read so the code generator
+        // doesn't have to re-hash them for symbol table look ups.
+        uint64_t hash = Token::hashCharacter(Token::HASH_SEED, currentChar);
         addCharacterToBuffer(currentChar);
         while (true)
         {
           currentChar = inspectCharacter();
           if (std::isalnum(currentChar) || '_' == currentChar)
           {
+            hash = Token::hashCharacter(hash, currentChar);
             addCharacterToBuffer(currentChar);
             advance();
           }
           else
           {
-            nextToken = idOrReserved(thisBuffer, tokenStartColumn);
+            nextToken = idOrReserved(thisBuffer, hash, tokenStartColumn);
             auto tokenLength = nextToken.getLiteral().size();
             if (Token::Type::Id == nextToken.getToken() &&
                 tokenLength > MAX_ID_LENGTH)
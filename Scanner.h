@@ -10,6 +10,7 @@
  */
 
 #include <cstdint>
+#include <deque>
 #include <fstream>
 #include <map>
 #include <string>
@@ -135,11 +136,14 @@ class Scanner
    *
    * @param theTokenLiteral
    *          token literal from source
+   * @param theTokenHash
+   *          hash of the token literal
    * @param theTokenStartColumn
    *          starting column of the token
    * @return Id or specific reserved word token
    */
   Token idOrReserved(const std::string &theTokenLiteral,
+                     uint64_t theTokenHash,
                      uint32_t theTokenStartColumn);
 
   /**
@@ -213,7 +217,7 @@ class Scanner
   Token *myPeekTokenPtr = nullptr;
 
   /** Tokens for printing remaining tokens from file for Assignment #3. */
-  std::vector<Token> myTokens;
+  std::deque<Token> myTokens;
 };
 
 #endif
@@ -0,0 +1,53 @@
+/**
+ * @file Statistics.cpp
+ * @brief Implementation of Statistics class
+ *
+ * @author Michael Albers
+ */
+
+#include <iomanip>
+
+#include "Statistics.h"
+
+//**************************************************
+// Statistics::add
+//**************************************************
+void Statistics::add(const std::string &theCounter, uint64_t theAmount)
+{
+  for (auto &counter : myCounters)
+  {
+    if (counter.first == theCounter)
+    {
+      counter.second += theAmount;
+      return;
+    }
+  }
+  myCounters.emplace_back(theCounter, theAmount);
+}
+
+//**************************************************
+// Statistics::get
+//**************************************************
+uint64_t Statistics::get(const std::string &theCounter) const noexcept
+{
+  for (auto &counter : myCounters)
+  {
+    if (counter.first == theCounter)
+    {
+      return counter.second;
+    }
+  }
+  return 0;
+}
+
+//**************************************************
+// Statistics::print
+//**************************************************
+void Statistics::print(std::ostream &theOS) const
+{
+  for (auto &counter : myCounters)
+  {
+    theOS << std::setw(12) << std::right << counter.second << "  "
+          << counter.first << std::endl;
+  }
+}
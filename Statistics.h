@@ -0,0 +1,103 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+/**
+ * @file Statistics.h
+ * @brief Defines the class used to collect compilation statistics.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Named counters collected during compilation (e.g., how many expressions
+ * an optimization changed). Counters are reported in the order in which
+ * they were first used.
+ */
+class Statistics
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  Statistics() = default;
+
+  /**
+   * Copy constructor
+   */
+  Statistics(const Statistics &) = default;
+
+  /**
+   * Move constructor
+   */
+  Statistics(Statistics &&) = default;
+
+  /**
+   * Destructor
+   */
+  ~Statistics() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  Statistics& operator=(const Statistics &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  Statistics& operator=(Statistics &&) = default;
+
+  /**
+   * Adds to a counter, creating it if needed.
+   *
+   * @param theCounter
+   *          counter name
+   * @param theAmount
+   *          amount to add
+   */
+  void add(const std::string &theCounter, uint64_t theAmount = 1);
+
+  /**
+   * Returns the value of a counter.
+   *
+   * @param theCounter
+   *          counter name
+   * @return counter value, 0 if the counter has never been used
+   */
+  uint64_t get(const std::string &theCounter) const noexcept;
+
+  /**
+   * Prints all counters, one per line.
+   *
+   * @param theOS
+   *          stream to print to
+   */
+  void print(std::ostream &theOS) const;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Counters, in order of first use. There are only ever a handful, so a
+   * linear search is fine.
+   */
+  std::vector<std::pair<std::string, uint64_t>> myCounters;
+};
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file StrengthReduction.cpp
+ * @brief Implementation of StrengthReduction class
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "OperatorRecord.h"
+#include "Program.h"
+#include "Statistics.h"
+#include "StrengthReduction.h"
+
+//**************************************************
+// StrengthReduction::getName
+//**************************************************
+const char* StrengthReduction::getName() const noexcept
+{
+  return "strength-reduction";
+}
+
+//**************************************************
+// StrengthReduction::run
+//**************************************************
+void StrengthReduction::run(Program &theProgram, AnalysisManager &theAnalyses,
+                            Statistics &theStatistics)
+{
+  auto &instructions = theProgram.getInstructions();
+  std::vector<Instruction> code;
+  code.reserve(instructions.size());
+  uint64_t folded = 0;
+  uint64_t reduced = 0;
+  uint64_t multiplies = 0;
+
+  for (auto &instruction : instructions)
+  {
+    auto &base = instruction.getOperand(0);
+    auto &exponent = instruction.getOperand(1);
+    if (Instruction::OpCode::Pow != instruction.getOpCode() ||
+        Operand::Kind::Literal != exponent.getKind())
+    {
+      code.push_back(instruction);
+      continue;
+    }
+
+    auto destination = instruction.getDestination();
+    int64_t result;
+    if (Operand::Kind::Literal == base.getKind())
+    {
+      if (OperatorRecord::power(base.getValue(), exponent.getValue(), result))
+      {
+        // Leave it to run time, as code generation does.
+        code.push_back(instruction);
+      }
+      else
+      {
+        code.emplace_back(Instruction::OpCode::Store,
+                          Operand(Operand::Kind::Literal, result),
+                          destination);
+        code.back().setLine(instruction.getLine());
+        ++folded;
+      }
+      continue;
+    }
+
+    auto power = exponent.getValue();
+    if (power < 0)
+    {
+      // Depends on whether the base is 1 or -1; leave it.
+      code.push_back(instruction);
+      continue;
+    }
+
+    ++reduced;
+    if (power <= 1)
+    {
+      code.emplace_back(Instruction::OpCode::Store,
+                        0 == power ? Operand(Operand::Kind::Literal, 1) : base,
+                        destination);
+      code.back().setLine(instruction.getLine());
+      continue;
+    }
+
+    // Left to right binary exponentiation: square for each bit after the
+    // most significant, multiplying by the base for each set bit.
+    auto product = base;
+    for (int bit = 62 - __builtin_clzll(power); bit >= 0; --bit)
+    {
+      bool multiply = (power >> bit) & 1;
+      auto square = (0 == bit && ! multiply) ? destination :
+        theProgram.newTemporary();
+      code.emplace_back(Instruction::OpCode::Mul, product, product, square);
+      code.back().setLine(instruction.getLine());
+      product = square;
+      ++multiplies;
+      if (multiply)
+      {
+        auto next = (0 == bit) ? destination : theProgram.newTemporary();
+        code.emplace_back(Instruction::OpCode::Mul, product, base, next);
+        code.back().setLine(instruction.getLine());
+        product = next;
+        ++multiplies;
+      }
+    }
+  }
+  instructions.swap(code);
+  setChanged(0 != folded + reduced);
+
+  theStatistics.add("exponentiations folded", folded);
+  theStatistics.add("exponentiations strength reduced", reduced);
+  theStatistics.add("multiplies generated", multiplies);
+}
@@ -0,0 +1,56 @@
+#ifndef STRENGTHREDUCTION_H
+#define STRENGTHREDUCTION_H
+
+/**
+ * @file StrengthReduction.h
+ * @brief Defines the pass which replaces exponentiation by multiplication.
+ *
+ * @author Michael Albers
+ */
+
+#include "Pass.h"
+
+/**
+ * Strength reduction of Pow with a constant exponent. x ** 0 becomes 1,
+ * x ** 1 becomes x, and any other non-negative exponent becomes a chain of
+ * squarings and multiplies by x (left to right binary exponentiation, so
+ * x ** 8 is three squarings). Pow of two literals is folded, unless it
+ * overflows.
+ *
+ * Runs before value numbering, so squarings shared between exponentiations
+ * of the same base are computed once.
+ */
+class StrengthReduction : public Pass
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  StrengthReduction() = default;
+
+  /**
+   * Destructor
+   */
+  virtual ~StrengthReduction() = default;
+
+  virtual const char* getName() const noexcept override;
+
+  virtual void run(Program &theProgram, AnalysisManager &theAnalyses,
+                   Statistics &theStatistics) override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+};
+
+#endif
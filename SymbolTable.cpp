@@ -0,0 +1,106 @@
+/**
+ * @file SymbolTable.cpp
+ * @brief Implementation of SymbolTable class
+ *
+ * @author Michael Albers
+ */
+
+#include "SymbolTable.h"
+
+//**************************************************
+// SymbolTable::SymbolTable
+//**************************************************
+SymbolTable::SymbolTable() :
+  mySlotShift(64 - INITIAL_SLOT_BITS),
+  mySlots(1u << INITIAL_SLOT_BITS, 0)
+{
+}
+
+//**************************************************
+// SymbolTable::find
+//**************************************************
+uint32_t SymbolTable::find(const std::string &theSymbol,
+                           uint64_t theHash) const noexcept
+{
+  const uint64_t mask = mySlots.size() - 1;
+  for (uint64_t slot = slotOf(theHash); mySlots[slot] != 0;
+       slot = (slot + 1) & mask)
+  {
+    uint32_t index = mySlots[slot] - 1;
+    if (myHashes[index] == theHash && mySymbols[index] == theSymbol)
+    {
+      return index;
+    }
+  }
+  return NOT_FOUND;
+}
+
+//**************************************************
+// SymbolTable::getSymbol
+//**************************************************
+const std::string& SymbolTable::getSymbol(uint32_t theIndex) const noexcept
+{
+  return mySymbols[theIndex];
+}
+
+//**************************************************
+// SymbolTable::grow
+//**************************************************
+void SymbolTable::grow()
+{
+  --mySlotShift;
+  mySlots.assign(mySlots.size() * 2, 0);
+  for (uint32_t index = 0; index < mySymbols.size(); ++index)
+  {
+    place(index);
+  }
+}
+
+//**************************************************
+// SymbolTable::insert
+//**************************************************
+uint32_t SymbolTable::insert(const std::string &theSymbol, uint64_t theHash)
+{
+  // Keep the load factor at or below 1/2 so probe sequences stay short.
+  if ((mySymbols.size() + 1) * 2 > mySlots.size())
+  {
+    grow();
+  }
+
+  uint32_t index = mySymbols.size();
+  mySymbols.push_back(theSymbol);
+  myHashes.push_back(theHash);
+  place(index);
+  return index;
+}
+
+//**************************************************
+// SymbolTable::place
+//**************************************************
+void SymbolTable::place(uint32_t theIndex) noexcept
+{
+  const uint64_t mask = mySlots.size() - 1;
+  uint64_t slot = slotOf(myHashes[theIndex]);
+  while (mySlots[slot] != 0)
+  {
+    slot = (slot + 1) & mask;
+  }
+  mySlots[slot] = theIndex + 1;
+}
+
+//**************************************************
+// SymbolTable::slotOf
+//**************************************************
+uint64_t SymbolTable::slotOf(uint64_t theHash) const noexcept
+{
+  // Fibonacci hashing; uses the well mixed high bits of the product.
+  return (theHash * 0x9E3779B97F4A7C15ull) >> mySlotShift;
+}
+
+//**************************************************
+// SymbolTable::size
+//**************************************************
+uint32_t SymbolTable::size() const noexcept
+{
+  return mySymbols.size();
+}
@@ -0,0 +1,153 @@
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+/**
+ * @file SymbolTable.h
+ * @brief Defines the table holding all known symbols.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Hash-indexed symbol table. Symbols are kept in insertion order (so
+ * declarations are always generated in the same order) and are indexed by an
+ * open addressing (linear probing) hash table. The hash of each symbol is
+ * supplied by the caller, typically precomputed by the scanner, so the symbol
+ * text is only compared on a full hash match.
+ */
+class SymbolTable
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** Index returned when a symbol is not in the table. */
+  static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+  /**
+   * Default constructor.
+   */
+  SymbolTable();
+
+  /**
+   * Copy constructor
+   */
+  SymbolTable(const SymbolTable &) = default;
+
+  /**
+   * Move constructor
+   */
+  SymbolTable(SymbolTable &&) = default;
+
+  /**
+   * Destructor
+   */
+  ~SymbolTable() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  SymbolTable& operator=(const SymbolTable &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  SymbolTable& operator=(SymbolTable &&) = default;
+
+  /**
+   * Finds the given symbol. The search is case sensitive.
+   *
+   * @param theSymbol
+   *          symbol to look for
+   * @param theHash
+   *          hash of the symbol (see Token::hash)
+   * @return insertion index of the symbol, or NOT_FOUND
+   */
+  uint32_t find(const std::string &theSymbol, uint64_t theHash) const noexcept;
+
+  /**
+   * Returns the symbol at the given insertion index.
+   *
+   * @param theIndex
+   *          insertion index of the symbol
+   * @return symbol
+   */
+  const std::string& getSymbol(uint32_t theIndex) const noexcept;
+
+  /**
+   * Unconditionally adds the symbol to the table. The caller is responsible
+   * for ensuring the symbol is not already in the table.
+   *
+   * @param theSymbol
+   *          symbol to add
+   * @param theHash
+   *          hash of the symbol (see Token::hash)
+   * @return insertion index of the new symbol
+   */
+  uint32_t insert(const std::string &theSymbol, uint64_t theHash);
+
+  /**
+   * Returns the number of symbols in the table.
+   *
+   * @return number of symbols
+   */
+  uint32_t size() const noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Log2 of the number of slots initially allocated. */
+  static constexpr uint32_t INITIAL_SLOT_BITS = 6;
+
+  /**
+   * Doubles the number of slots and re-indexes all symbols.
+   */
+  void grow();
+
+  /**
+   * Places the symbol with the given insertion index into the first free
+   * slot of its probe sequence.
+   *
+   * @param theIndex
+   *          insertion index of the symbol
+   */
+  void place(uint32_t theIndex) noexcept;
+
+  /**
+   * Returns the first slot of the probe sequence for the given hash.
+   *
+   * @param theHash
+   *          symbol hash
+   * @return slot index
+   */
+  uint64_t slotOf(uint64_t theHash) const noexcept;
+
+  /** Hash of each symbol, in insertion order. */
+  std::vector<uint64_t> myHashes;
+
+  /** 64 - log2 of the number of slots. */
+  uint32_t mySlotShift;
+
+  /**
+   * Open addressing slots. Each holds insertion index + 1, or 0 if the slot
+   * is empty.
+   */
+  std::vector<uint32_t> mySlots;
+
+  /** Symbols, in insertion order. */
+  std::vector<std::string> mySymbols;
+};
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file TemporaryAllocation.cpp
+ * @brief Implementation of TemporaryAllocation class
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "Program.h"
+#include "Statistics.h"
+#include "TemporaryAllocation.h"
+
+//**************************************************
+// TemporaryAllocation::getName
+//**************************************************
+const char* TemporaryAllocation::getName() const noexcept
+{
+  return "temporary-allocation";
+}
+
+//**************************************************
+// TemporaryAllocation::run
+//**************************************************
+void TemporaryAllocation::run(Program &theProgram, AnalysisManager &theAnalyses,
+                              Statistics &theStatistics)
+{
+  auto &instructions = theProgram.getInstructions();
+  auto temporaryCount = theProgram.getTemporaryCount();
+
+  // End of each live range: the last instruction reading the temporary.
+  std::vector<std::size_t> lastUse(temporaryCount + 1, 0);
+  for (std::size_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    auto &instruction = instructions[ii];
+    for (uint32_t source = 0; source < instruction.getSourceCount(); ++source)
+    {
+      auto &operand = instruction.getOperand(source);
+      if (Operand::Kind::Temporary == operand.getKind())
+      {
+        lastUse[operand.getIndex()] = ii;
+      }
+    }
+  }
+
+  // Slot assigned to each temporary (0 if none yet) and the free slots,
+  // lowest first so numbering is deterministic.
+  std::vector<uint32_t> slotOf(temporaryCount + 1, 0);
+  std::priority_queue<uint32_t, std::vector<uint32_t>,
+                      std::greater<uint32_t>> freeSlots;
+  uint32_t slotCount = 0;
+  uint32_t usedCount = 0;
+
+  for (std::size_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    auto &instruction = instructions[ii];
+
+    // Sources are read before the destination is written, so temporaries
+    // dying here can be reused for this instruction's result.
+    Operand sources[Instruction::MAX_OPERANDS];
+    for (uint32_t source = 0; source < instruction.getSourceCount(); ++source)
+    {
+      sources[source] = instruction.getOperand(source);
+      if (Operand::Kind::Temporary == sources[source].getKind())
+      {
+        instruction.setOperand(
+          source, Operand(Operand::Kind::Temporary,
+                          slotOf[sources[source].getIndex()]));
+      }
+    }
+    for (uint32_t source = 0; source < instruction.getSourceCount(); ++source)
+    {
+      auto temporary = sources[source].getIndex();
+      if (Operand::Kind::Temporary == sources[source].getKind() &&
+          lastUse[temporary] == ii && slotOf[temporary] != 0)
+      {
+        freeSlots.push(slotOf[temporary]);
+        slotOf[temporary] = 0;
+      }
+    }
+
+    if (instruction.hasDestination() &&
+        Operand::Kind::Temporary == instruction.getDestination().getKind())
+    {
+      auto temporary = instruction.getDestination().getIndex();
+      ++usedCount;
+      uint32_t slot;
+      if (freeSlots.empty())
+      {
+        slot = ++slotCount;
+      }
+      else
+      {
+        slot = freeSlots.top();
+        freeSlots.pop();
+      }
+      instruction.setDestination(Operand(Operand::Kind::Temporary, slot));
+
+      if (lastUse[temporary] > ii)
+      {
+        slotOf[temporary] = slot;
+      }
+      else
+      {
+        // Never read, the slot is free again straight away.
+        freeSlots.push(slot);
+      }
+    }
+  }
+
+  theProgram.setTemporaryCount(slotCount);
+  theStatistics.add("temporaries before allocation", usedCount);
+  theStatistics.add("temporaries after allocation", slotCount);
+}
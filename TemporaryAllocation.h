@@ -0,0 +1,56 @@
+#ifndef TEMPORARYALLOCATION_H
+#define TEMPORARYALLOCATION_H
+
+/**
+ * @file TemporaryAllocation.h
+ * @brief Defines the pass which reuses temporaries once they are dead.
+ *
+ * @author Michael Albers
+ */
+
+#include "Pass.h"
+
+/**
+ * Linear scan allocation of temporaries. Code generation creates a new
+ * temporary for every intermediate result; this pass computes the live range
+ * of each (definition to last use) and maps them onto as few temporary slots
+ * as possible, reusing a slot as soon as the temporary in it is dead. The
+ * number of temporaries declared becomes the maximum number live at once.
+ *
+ * Afterwards a temporary may be assigned more than once, so this must be the
+ * last pass run.
+ */
+class TemporaryAllocation : public Pass
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  TemporaryAllocation() = default;
+
+  /**
+   * Destructor
+   */
+  virtual ~TemporaryAllocation() = default;
+
+  virtual const char* getName() const noexcept override;
+
+  virtual void run(Program &theProgram, AnalysisManager &theAnalyses,
+                   Statistics &theStatistics) override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+};
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file TextBackend.cpp
+ * @brief Implementation of TextBackend class
+ *
+ * @author Michael Albers
+ */
+
+#include <vector>
+
+#include "Instruction.h"
+#include "OutputSink.h"
+#include "Program.h"
+#include "TextBackend.h"
+
+//**************************************************
+// TextBackend::emit
+//**************************************************
+void TextBackend::emit(const Program &theProgram, OutputSink &theSink)
+{
+  std::vector<bool> declared(theProgram.getTemporaryCount() + 1, false);
+  std::string line;
+
+  for (auto &instruction : theProgram.getInstructions())
+  {
+    for (uint32_t ii = 0; ii < Instruction::MAX_OPERANDS; ++ii)
+    {
+      auto &operand = instruction.getOperand(ii);
+      if (Operand::Kind::Temporary == operand.getKind() &&
+          ! declared[operand.getIndex()])
+      {
+        declared[operand.getIndex()] = true;
+        format(theProgram,
+               Instruction(Instruction::OpCode::Declare, operand), line);
+        line.push_back('\n');
+        theSink.write(line);
+      }
+    }
+
+    format(theProgram, instruction, line);
+    line.push_back('\n');
+    theSink.write(line);
+  }
+}
+
+//**************************************************
+// TextBackend::format
+//**************************************************
+void TextBackend::format(const Program &theProgram,
+                         const Instruction &theInstruction,
+                         std::string &theLine)
+{
+  auto name = [&](uint32_t theIndex)
+  {
+    return theProgram.getName(theInstruction.getOperand(theIndex));
+  };
+
+  theLine.assign(getMnemonic(theInstruction.getOpCode()));
+  switch (theInstruction.getOpCode())
+  {
+    case Instruction::OpCode::Declare:
+    case Instruction::OpCode::Read:
+    case Instruction::OpCode::Write:
+      theLine += " " + name(0) + ", Integer";
+      break;
+
+    case Instruction::OpCode::Store:
+      theLine += " " + name(0) + ", " + name(1);
+      break;
+
+    case Instruction::OpCode::Add:
+    case Instruction::OpCode::Sub:
+    case Instruction::OpCode::Mul:
+    case Instruction::OpCode::Pow:
+      theLine += " " + name(0) + ", " + name(1) + ", " + name(2);
+      break;
+
+    case Instruction::OpCode::Halt:
+      break;
+  }
+}
+
+//**************************************************
+// TextBackend::getMnemonic
+//**************************************************
+const char* TextBackend::getMnemonic(Instruction::OpCode theOpCode) noexcept
+{
+  switch (theOpCode)
+  {
+    case Instruction::OpCode::Declare:
+      return "Declare";
+
+    case Instruction::OpCode::Read:
+      return "Read";
+
+    case Instruction::OpCode::Write:
+      return "Write";
+
+    case Instruction::OpCode::Store:
+      return "Store";
+
+    case Instruction::OpCode::Add:
+      return "ADD";
+
+    case Instruction::OpCode::Sub:
+      return "SUB";
+
+    case Instruction::OpCode::Mul:
+      return "MUL";
+
+    case Instruction::OpCode::Pow:
+      return "POW";
+
+    case Instruction::OpCode::Halt:
+      return "Halt";
+  }
+  return "";
+}
@@ -0,0 +1,104 @@
+#ifndef TEXTBACKEND_H
+#define TEXTBACKEND_H
+
+/**
+ * @file TextBackend.h
+ * @brief Defines the class which writes programs as textual pseudo-assembly.
+ *
+ * @author Michael Albers
+ */
+
+#include <string>
+
+#include "Instruction.h"
+
+class OutputSink;
+class Program;
+
+/**
+ * Writes a program as the textual pseudo-assembly of the Micro target
+ * machine (Declare, Read, Write, Store, ADD, SUB, Halt).
+ */
+class TextBackend
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  TextBackend() = default;
+
+  /**
+   * Copy constructor
+   */
+  TextBackend(const TextBackend &) = delete;
+
+  /**
+   * Move constructor
+   */
+  TextBackend(TextBackend &&) = delete;
+
+  /**
+   * Destructor
+   */
+  ~TextBackend() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  TextBackend& operator=(const TextBackend &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  TextBackend& operator=(TextBackend &&) = delete;
+
+  /**
+   * Writes the program. Temporaries are declared just before the first
+   * instruction referring to them.
+   *
+   * @param theProgram
+   *          program to write
+   * @param theSink
+   *          destination
+   */
+  void emit(const Program &theProgram, OutputSink &theSink);
+
+  /**
+   * Formats one instruction (without a newline).
+   *
+   * @param theProgram
+   *          program containing the instruction
+   * @param theInstruction
+   *          instruction to format
+   * @param theLine
+   *          set to the instruction text
+   */
+  static void format(const Program &theProgram,
+                     const Instruction &theInstruction,
+                     std::string &theLine);
+
+  /**
+   * Returns the mnemonic of an op code (e.g., "ADD").
+   *
+   * @param theOpCode
+   *          op code
+   * @return mnemonic
+   */
+  static const char* getMnemonic(Instruction::OpCode theOpCode) noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+};
+
+#endif
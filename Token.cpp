@@ -44,7 +44,20 @@ Token::Token(Type theToken,
              const std::string &theTokenLiteral,
              uint32_t theLine,
              uint32_t theColumn) :
+  Token(theToken, theTokenLiteral, hash(theTokenLiteral), theLine, theColumn)
+{
+}
+
+//*************
+// Token::Token
+//*************
+Token::Token(Type theToken,
+             const std::string &theTokenLiteral,
+             uint64_t theHash,
+             uint32_t theLine,
+             uint32_t theColumn) :
   myColumn(theColumn),
+  myHash(theHash),
   myLine(theLine),
   myToken(theToken),
   myTokenLiteral(theTokenLiteral)
@@ -59,6 +72,14 @@ uint32_t Token::getColumn() const noexcept
   return myColumn;
 }
 
+//***************
+// Token::getHash
+//***************
+uint64_t Token::getHash() const noexcept
+{
+  return myHash;
+}
+
 //***************
 // Token::getLine
 //***************
@@ -91,6 +112,28 @@ std::string Token::getTokenString() const noexcept
   return ourTokenDescriptions[getToken()];
 }
 
+//************
+// Token::hash
+//************
+uint64_t Token::hash(const std::string &theString) noexcept
+{
+  uint64_t hash = HASH_SEED;
+  for (auto character : theString)
+  {
+    hash = hashCharacter(hash, character);
+  }
+  return hash;
+}
+
+//*********************
+// Token::hashCharacter
+//*********************
+uint64_t Token::hashCharacter(uint64_t theHash, char theCharacter) noexcept
+{
+  return (theHash ^ static_cast<unsigned char>(theCharacter)) *
+    0x100000001b3ull;
+}
+
 //*****************
 // Token::operator<
 //*****************
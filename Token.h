@@ -91,6 +91,26 @@ class Token
         uint32_t theLine,
         uint32_t theColumn);
 
+  /**
+   * Constructor
+   *
+   * @param theToken
+   *          token
+   * @param theTokenLiteral
+   *          literal token string from source
+   * @param theHash
+   *          hash of theTokenLiteral, as computed by hash/hashCharacter
+   * @param theLine
+   *          line on which the token appears
+   * @param theColumn
+   *          column on which the token starts
+   */
+  Token(Type theToken,
+        const std::string &theTokenLiteral,
+        uint64_t theHash,
+        uint32_t theLine,
+        uint32_t theColumn);
+
   /**
    * Destructor
    */
@@ -152,6 +172,13 @@ class Token
    */
   uint32_t getColumn() const noexcept;
 
+  /**
+   * Returns the hash of the token literal.
+   *
+   * @return hash of the token literal
+   */
+  uint64_t getHash() const noexcept;
+
   /**
    * Returns the line on which the token appears.
    *
@@ -181,6 +208,31 @@ class Token
    */
   std::string getTokenString() const noexcept;
 
+  /**
+   * Hashes a string (64-bit FNV-1a). Equivalent to starting with HASH_SEED
+   * and calling hashCharacter for each character in the string.
+   *
+   * @param theString
+   *          string to hash
+   * @return hash of the string
+   */
+  static uint64_t hash(const std::string &theString) noexcept;
+
+  /**
+   * Adds one character to a running hash. Lets the scanner hash literals as
+   * it reads them.
+   *
+   * @param theHash
+   *          hash of the characters seen so far
+   * @param theCharacter
+   *          next character
+   * @return updated hash
+   */
+  static uint64_t hashCharacter(uint64_t theHash, char theCharacter) noexcept;
+
+  /** Hash of the empty string. */
+  static constexpr uint64_t HASH_SEED = 0xcbf29ce484222325ull;
+
   // ************************************************************
   // Protected
   // ************************************************************
@@ -194,6 +246,9 @@ class Token
   /** Column (character in line) on which the token starts. */
   uint32_t myColumn = 0;
 
+  /** Hash of the token literal. */
+  uint64_t myHash = HASH_SEED;
+
   /** Line on which the token appears. */
   uint32_t myLine = 0;
 
@@ -0,0 +1,230 @@
+/**
+ * @file ValueNumbering.cpp
+ * @brief Implementation of ValueNumbering class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "Program.h"
+#include "Statistics.h"
+#include "ValueNumbering.h"
+
+// Static Variables
+constexpr uint32_t ValueNumbering::NO_VALUE;
+
+//**************************************************
+// ValueNumbering::getName
+//**************************************************
+const char* ValueNumbering::getName() const noexcept
+{
+  return "value-numbering";
+}
+
+//**************************************************
+// ValueNumbering::isAvailable
+//**************************************************
+bool ValueNumbering::isAvailable(uint32_t theValue) const noexcept
+{
+  auto &holder = myHolders[theValue];
+  switch (holder.getKind())
+  {
+    case Operand::Kind::Symbol:
+      // Symbols can be reassigned, so it only holds the value until then.
+      return mySymbolValues[holder.getIndex()] == theValue;
+
+    case Operand::Kind::Literal:
+    case Operand::Kind::Temporary:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+//**************************************************
+// ValueNumbering::newValue
+//**************************************************
+uint32_t ValueNumbering::newValue(const Operand &theHolder)
+{
+  myHolders.push_back(theHolder);
+  return myHolders.size() - 1;
+}
+
+//**************************************************
+// ValueNumbering::run
+//**************************************************
+void ValueNumbering::run(Program &theProgram, AnalysisManager &theAnalyses,
+                         Statistics &theStatistics)
+{
+  auto &instructions = theProgram.getInstructions();
+
+  myExpressions.clear();
+  myHolders.assign(1, Operand()); // NO_VALUE
+  myLiteralValues.clear();
+  mySymbolValues.assign(theProgram.getSymbolTable().size(), NO_VALUE);
+  myTemporaryValues.assign(theProgram.getTemporaryCount() + 1, NO_VALUE);
+
+  // Temporaries whose computation was removed, and what to use instead.
+  std::vector<Operand> replacements(theProgram.getTemporaryCount() + 1);
+  std::vector<bool> removed(instructions.size(), false);
+  uint64_t reused = 0;
+
+  for (std::size_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    auto &instruction = instructions[ii];
+
+    for (uint32_t source = 0; source < instruction.getSourceCount(); ++source)
+    {
+      auto &operand = instruction.getOperand(source);
+      if (Operand::Kind::Temporary == operand.getKind() &&
+          Operand::Kind::None !=
+            replacements[operand.getIndex()].getKind())
+      {
+        instruction.setOperand(source, replacements[operand.getIndex()]);
+      }
+    }
+
+    switch (instruction.getOpCode())
+    {
+      case Instruction::OpCode::Add:
+      case Instruction::OpCode::Sub:
+      case Instruction::OpCode::Mul:
+      case Instruction::OpCode::Pow:
+      {
+        uint64_t left = valueOf(instruction.getOperand(0));
+        uint64_t right = valueOf(instruction.getOperand(1));
+        auto opCode = instruction.getOpCode();
+        if ((Instruction::OpCode::Add == opCode ||
+             Instruction::OpCode::Mul == opCode) && left > right)
+        {
+          std::swap(left, right);
+        }
+        uint64_t key = (left << 34) | (right << 3) |
+          static_cast<uint64_t>(opCode);
+
+        auto destination = instruction.getDestination();
+        auto expression = myExpressions.find(key);
+        if (expression != myExpressions.end() &&
+            isAvailable(expression->second))
+        {
+          ++reused;
+          auto value = expression->second;
+          auto &holder = myHolders[value];
+          if (Operand::Kind::Temporary == destination.getKind() &&
+              Operand::Kind::Symbol != holder.getKind())
+          {
+            // Temporaries and literals never change, use them directly.
+            replacements[destination.getIndex()] = holder;
+            removed[ii] = true;
+          }
+          else
+          {
+            // A symbol may be reassigned while the result is still needed,
+            // so copy the value out of it.
+            auto line = instruction.getLine();
+            instruction = Instruction(Instruction::OpCode::Store,
+                                      holder, destination);
+            instruction.setLine(line);
+          }
+          setValue(destination, value);
+        }
+        else
+        {
+          auto value = newValue(destination);
+          myExpressions[key] = value;
+          setValue(destination, value);
+        }
+      }
+      break;
+
+      case Instruction::OpCode::Store:
+      {
+        auto value = valueOf(instruction.getOperand(0));
+        auto &destination = instruction.getDestination();
+        setValue(destination, value);
+        if (! isAvailable(value))
+        {
+          myHolders[value] = destination;
+        }
+      }
+      break;
+
+      case Instruction::OpCode::Read:
+      {
+        auto &destination = instruction.getDestination();
+        setValue(destination, newValue(destination));
+      }
+      break;
+
+      default:
+        break;
+    }
+  }
+
+  std::size_t before = instructions.size();
+  std::size_t kept = 0;
+  for (std::size_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    if (! removed[ii])
+    {
+      instructions[kept++] = instructions[ii];
+    }
+  }
+  instructions.resize(kept);
+  setChanged(0 != reused);
+
+  theStatistics.add("instructions before value numbering", before);
+  theStatistics.add("instructions after value numbering", kept);
+  theStatistics.add("common subexpressions reused", reused);
+}
+
+//**************************************************
+// ValueNumbering::setValue
+//**************************************************
+void ValueNumbering::setValue(const Operand &theOperand,
+                              uint32_t theValue) noexcept
+{
+  if (Operand::Kind::Symbol == theOperand.getKind())
+  {
+    mySymbolValues[theOperand.getIndex()] = theValue;
+  }
+  else if (Operand::Kind::Temporary == theOperand.getKind())
+  {
+    myTemporaryValues[theOperand.getIndex()] = theValue;
+  }
+}
+
+//**************************************************
+// ValueNumbering::valueOf
+//**************************************************
+uint32_t ValueNumbering::valueOf(const Operand &theOperand)
+{
+  uint32_t *value = nullptr;
+  switch (theOperand.getKind())
+  {
+    case Operand::Kind::Literal:
+      value = &myLiteralValues[theOperand.getValue()];
+      break;
+
+    case Operand::Kind::Symbol:
+      value = &mySymbolValues[theOperand.getIndex()];
+      break;
+
+    case Operand::Kind::Temporary:
+      value = &myTemporaryValues[theOperand.getIndex()];
+      break;
+
+    default:
+      return NO_VALUE;
+  }
+
+  // First use of a literal, or a variable used before it is assigned.
+  if (NO_VALUE == *value)
+  {
+    *value = newValue(theOperand);
+  }
+  return *value;
+}
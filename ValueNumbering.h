@@ -0,0 +1,115 @@
+#ifndef VALUENUMBERING_H
+#define VALUENUMBERING_H
+
+/**
+ * @file ValueNumbering.h
+ * @brief Defines the local value numbering pass.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Operand.h"
+#include "Pass.h"
+
+/**
+ * Local value numbering (common subexpression elimination) over the whole
+ * straight-line program. Every value computed gets a number; an arithmetic
+ * instruction whose operator and operand value numbers were seen before reuses the
+ * earlier result instead of computing it again, as long as something still
+ * holds that result. Assignments (Store, Read) give the assigned variable a
+ * new value number, which kills expressions using its old value. Add and Mul
+ * are commutative, so their operands are put in a canonical order first.
+ */
+class ValueNumbering : public Pass
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  ValueNumbering() = default;
+
+  /**
+   * Destructor
+   */
+  virtual ~ValueNumbering() = default;
+
+  virtual const char* getName() const noexcept override;
+
+  virtual void run(Program &theProgram, AnalysisManager &theAnalyses,
+                   Statistics &theStatistics) override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Value number meaning "not numbered yet". */
+  static constexpr uint32_t NO_VALUE = 0;
+
+  /**
+   * Returns if the value is still held by its holder.
+   *
+   * @param theValue
+   *          value number
+   * @return true if the holder can be used in place of recomputing
+   */
+  bool isAvailable(uint32_t theValue) const noexcept;
+
+  /**
+   * Creates a new value number.
+   *
+   * @param theHolder
+   *          operand holding the value
+   * @return new value number
+   */
+  uint32_t newValue(const Operand &theHolder);
+
+  /**
+   * Records that an operand has been assigned a value.
+   *
+   * @param theOperand
+   *          symbol or temporary
+   * @param theValue
+   *          value number
+   */
+  void setValue(const Operand &theOperand, uint32_t theValue) noexcept;
+
+  /**
+   * Returns the value number of an operand, numbering it if needed.
+   *
+   * @param theOperand
+   *          operand
+   * @return value number
+   */
+  uint32_t valueOf(const Operand &theOperand);
+
+  /** Expression (op code and operand values) to value number. */
+  std::unordered_map<uint64_t, uint32_t> myExpressions;
+
+  /** Operand holding each value, indexed by value number. */
+  std::vector<Operand> myHolders;
+
+  /** Value number of each literal value. */
+  std::unordered_map<int64_t, uint32_t> myLiteralValues;
+
+  /** Current value number of each symbol. */
+  std::vector<uint32_t> mySymbolValues;
+
+  /** Value number of each temporary. */
+  std::vector<uint32_t> myTemporaryValues;
+};
+
+#endif
@@ -0,0 +1,228 @@
+/**
+ * @file VirtualMachine.cpp
+ * @brief Implementation of VirtualMachine class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "Bytecode.h"
+#include "Runtime.h"
+#include "VirtualMachine.h"
+
+// Define as 0 to build the switch fallback with GCC or Clang.
+#ifndef MICRO_COMPUTED_GOTO
+#if defined(__GNUC__)
+#define MICRO_COMPUTED_GOTO 1
+#else
+#define MICRO_COMPUTED_GOTO 0
+#endif
+#endif
+
+//**************************************************
+// VirtualMachine::getDispatchCount
+//**************************************************
+uint64_t VirtualMachine::getDispatchCount() const noexcept
+{
+  return myDispatchCount;
+}
+
+//**************************************************
+// VirtualMachine::getSavedDispatchCount
+//**************************************************
+uint64_t VirtualMachine::getSavedDispatchCount() const noexcept
+{
+  return mySavedDispatchCount;
+}
+
+//**************************************************
+// VirtualMachine::isComputedGoto
+//**************************************************
+bool VirtualMachine::isComputedGoto() noexcept
+{
+  return MICRO_COMPUTED_GOTO;
+}
+
+//**************************************************
+// VirtualMachine::run
+//**************************************************
+void VirtualMachine::run(const Bytecode &theBytecode)
+{
+  auto &constants = theBytecode.getConstants();
+  run(theBytecode.getOperations().data(), constants.data(), constants.size(),
+      theBytecode.getConstantBase(), theBytecode.getLines().data());
+}
+
+//**************************************************
+// VirtualMachine::run
+//**************************************************
+void VirtualMachine::run(const Bytecode::Operation *theOperations,
+                         const int64_t *theConstants,
+                         uint32_t theConstantCount, uint32_t theConstantBase,
+                         const uint32_t *theLines)
+{
+  std::vector<int64_t> frameStorage(theConstantBase + theConstantCount, 0);
+  std::copy(theConstants, theConstants + theConstantCount,
+            frameStorage.begin() + theConstantBase);
+
+  int64_t *frame = frameStorage.data();
+  const Bytecode::Operation *operation = theOperations;
+  uint64_t dispatches = 0;
+  uint64_t saved = 0;
+
+  // Arithmetic is done unsigned so overflow wraps.
+#define MICRO_ARITHMETIC(op)                                            \
+  frame[operation->myOperands[2]] = static_cast<int64_t>(               \
+    static_cast<uint64_t>(frame[operation->myOperands[0]]) op           \
+    static_cast<uint64_t>(frame[operation->myOperands[1]]))
+
+  // Checked arithmetic stops the program on signed overflow.
+#define MICRO_CHECKED(builtin)                                          \
+  if (builtin(frame[operation->myOperands[0]],                          \
+              frame[operation->myOperands[1]],                          \
+              &frame[operation->myOperands[2]]))                        \
+  {                                                                     \
+    micro_overflow(theLines[operation - theOperations]);                \
+  }
+
+  // Superinstructions covering theCount operations skip the rest.
+#define MICRO_SKIP(theCount)                                            \
+  saved += (theCount) - 1;                                              \
+  operation += (theCount) - 1
+
+#if MICRO_COMPUTED_GOTO
+  // In OpCode order.
+  static void *const handlers[Bytecode::OPCODE_COUNT] = {
+    &&Read, &&Write, &&Move, &&Add, &&Sub, &&Mul, &&Pow, &&Halt,
+    &&ReadN, &&WriteN, &&AddMove, &&SubMove, &&AddWrite, &&SubWrite,
+    &&CheckedAdd, &&CheckedSub, &&CheckedMul, &&CheckedPow};
+#define MICRO_DISPATCH()                                                \
+  ++dispatches;                                                         \
+  goto *handlers[static_cast<uint32_t>(operation->myOpCode)]
+#define MICRO_CASE(name) name
+#define MICRO_NEXT() ++operation; MICRO_DISPATCH()
+
+  MICRO_DISPATCH();
+#else
+#define MICRO_CASE(name) case Bytecode::OpCode::name
+#define MICRO_NEXT() ++operation; continue
+
+  for (;;)
+  {
+    ++dispatches;
+    switch (operation->myOpCode)
+    {
+#endif
+
+  MICRO_CASE(Read):
+    frame[operation->myOperands[0]] = micro_read();
+    MICRO_NEXT();
+
+  MICRO_CASE(Write):
+    micro_write(frame[operation->myOperands[0]]);
+    MICRO_NEXT();
+
+  MICRO_CASE(Move):
+    frame[operation->myOperands[1]] = frame[operation->myOperands[0]];
+    MICRO_NEXT();
+
+  MICRO_CASE(Add):
+    MICRO_ARITHMETIC(+);
+    MICRO_NEXT();
+
+  MICRO_CASE(Sub):
+    MICRO_ARITHMETIC(-);
+    MICRO_NEXT();
+
+  MICRO_CASE(Mul):
+    MICRO_ARITHMETIC(*);
+    MICRO_NEXT();
+
+  MICRO_CASE(Pow):
+    frame[operation->myOperands[2]] = micro_power(
+      frame[operation->myOperands[0]], frame[operation->myOperands[1]]);
+    MICRO_NEXT();
+
+  MICRO_CASE(ReadN):
+  {
+    auto count = operation->myOperands[1];
+    for (uint32_t ii = 0; ii < count; ++ii)
+    {
+      frame[operation[ii].myOperands[0]] = micro_read();
+    }
+    MICRO_SKIP(count);
+  }
+  MICRO_NEXT();
+
+  MICRO_CASE(WriteN):
+  {
+    auto count = operation->myOperands[1];
+    for (uint32_t ii = 0; ii < count; ++ii)
+    {
+      micro_write(frame[operation[ii].myOperands[0]]);
+    }
+    MICRO_SKIP(count);
+  }
+  MICRO_NEXT();
+
+  MICRO_CASE(AddMove):
+    MICRO_ARITHMETIC(+);
+    frame[operation[1].myOperands[1]] = frame[operation->myOperands[2]];
+    MICRO_SKIP(2);
+    MICRO_NEXT();
+
+  MICRO_CASE(SubMove):
+    MICRO_ARITHMETIC(-);
+    frame[operation[1].myOperands[1]] = frame[operation->myOperands[2]];
+    MICRO_SKIP(2);
+    MICRO_NEXT();
+
+  MICRO_CASE(AddWrite):
+    MICRO_ARITHMETIC(+);
+    micro_write(frame[operation->myOperands[2]]);
+    MICRO_SKIP(2);
+    MICRO_NEXT();
+
+  MICRO_CASE(SubWrite):
+    MICRO_ARITHMETIC(-);
+    micro_write(frame[operation->myOperands[2]]);
+    MICRO_SKIP(2);
+    MICRO_NEXT();
+
+  MICRO_CASE(CheckedAdd):
+    MICRO_CHECKED(__builtin_add_overflow);
+    MICRO_NEXT();
+
+  MICRO_CASE(CheckedSub):
+    MICRO_CHECKED(__builtin_sub_overflow);
+    MICRO_NEXT();
+
+  MICRO_CASE(CheckedMul):
+    MICRO_CHECKED(__builtin_mul_overflow);
+    MICRO_NEXT();
+
+  MICRO_CASE(CheckedPow):
+    frame[operation->myOperands[2]] = micro_power_checked(
+      frame[operation->myOperands[0]], frame[operation->myOperands[1]],
+      theLines[operation - theOperations]);
+    MICRO_NEXT();
+
+  MICRO_CASE(Halt):
+    myDispatchCount = dispatches;
+    mySavedDispatchCount = saved;
+    return;
+
+#if ! MICRO_COMPUTED_GOTO
+    }
+  }
+#endif
+
+#undef MICRO_ARITHMETIC
+#undef MICRO_CASE
+#undef MICRO_CHECKED
+#undef MICRO_DISPATCH
+#undef MICRO_NEXT
+#undef MICRO_SKIP
+}
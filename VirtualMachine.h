@@ -0,0 +1,131 @@
+#ifndef VIRTUALMACHINE_H
+#define VIRTUALMACHINE_H
+
+/**
+ * @file VirtualMachine.h
+ * @brief Defines the interpreter for bytecode.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+
+#include "Bytecode.h"
+
+/**
+ * Interprets bytecode (see Bytecode). Read, Write and Pow use the runtime
+ * library (see Runtime.h), so a program behaves the same as when compiled
+ * to native code.
+ *
+ * Where the compiler supports taking the address of a label (GCC, Clang),
+ * each operation's handler jumps straight to the next one's through a
+ * table (computed goto), giving the branch predictor one indirect branch
+ * per handler to learn. Otherwise it falls back to a loop around a switch.
+ *
+ * Every dispatch is counted, along with the dispatches superinstructions
+ * save (see Bytecode::fuse), so their effect can be measured.
+ */
+class VirtualMachine
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  VirtualMachine() = default;
+
+  /**
+   * Copy constructor
+   */
+  VirtualMachine(const VirtualMachine &) = delete;
+
+  /**
+   * Move constructor
+   */
+  VirtualMachine(VirtualMachine &&) = delete;
+
+  /**
+   * Destructor
+   */
+  ~VirtualMachine() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  VirtualMachine& operator=(const VirtualMachine &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  VirtualMachine& operator=(VirtualMachine &&) = delete;
+
+  /**
+   * Runs a program once, with a fresh frame (variables 0).
+   *
+   * @param theBytecode
+   *          program to run
+   */
+  void run(const Bytecode &theBytecode);
+
+  /**
+   * Runs a program once, with a fresh frame (variables 0), from its parts
+   * (e.g., as mapped from an ObjectFile).
+   *
+   * @param theOperations
+   *          operations, ending with Halt
+   * @param theConstants
+   *          constant pool
+   * @param theConstantCount
+   *          number of constants
+   * @param theConstantBase
+   *          frame slot of the first constant
+   * @param theLines
+   *          source line of each operation (for checked arithmetic)
+   */
+  void run(const Bytecode::Operation *theOperations,
+           const int64_t *theConstants, uint32_t theConstantCount,
+           uint32_t theConstantBase, const uint32_t *theLines);
+
+  /**
+   * Returns the number of dispatches made by the last run.
+   *
+   * @return dispatches (operations executed)
+   */
+  uint64_t getDispatchCount() const noexcept;
+
+  /**
+   * Returns the number of dispatches superinstructions saved in the last
+   * run, i.e., how many more an unfused program would have made.
+   *
+   * @return dispatches saved
+   */
+  uint64_t getSavedDispatchCount() const noexcept;
+
+  /**
+   * Returns if dispatch is by computed goto (rather than a switch).
+   *
+   * @return true if computed goto is used
+   */
+  static bool isComputedGoto() noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Dispatches made by the last run. */
+  uint64_t myDispatchCount = 0;
+
+  /** Dispatches saved by superinstructions in the last run. */
+  uint64_t mySavedDispatchCount = 0;
+};
+
+#endif
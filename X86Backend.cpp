@@ -0,0 +1,506 @@
+/**
+ * @file X86Backend.cpp
+ * @brief Implementation of X86Backend class
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdio>
+#include <utility>
+
+#include "Instruction.h"
+#include "OutputSink.h"
+#include "Program.h"
+#include "SSAForm.h"
+#include "Statistics.h"
+#include "TextBackend.h"
+#include "X86Backend.h"
+
+const char* const X86Backend::REGISTERS[] = {
+  "%rcx", "%rsi", "%rdi", "%r8", "%r9", "%r10", "%r11",
+  "%rbx", "%rbp", "%r12", "%r13", "%r14", "%r15"};
+
+constexpr uint32_t X86Backend::REGISTER_COUNT;
+constexpr uint32_t X86Backend::SCRATCH_COUNT;
+constexpr uint32_t X86Backend::NO_LINE;
+
+//**************************************************
+// X86Backend::X86Backend
+//**************************************************
+X86Backend::X86Backend(bool theChecked,
+                       CompilerOptions::Instrument theInstrument,
+                       const std::string &theSource) :
+  myAllocator(SCRATCH_COUNT, REGISTER_COUNT - SCRATCH_COUNT),
+  myChecked(theChecked),
+  myInstrument(theInstrument),
+  mySource(theSource)
+{
+}
+
+//**************************************************
+// X86Backend::emit
+//**************************************************
+void X86Backend::emit(const Program &theProgram, OutputSink &theSink,
+                      Statistics &theStatistics)
+{
+  SSAForm ssa(theProgram);
+  myProgram = &theProgram;
+  mySink = &theSink;
+  mySSA = &ssa;
+  myTrapLines.clear();
+  myAllocator.allocate(theProgram, ssa, isCall);
+
+  // Lines are profiled in the order their code first appears.
+  myProfileIndex.clear();
+  myProfileLines.clear();
+  myProfileLine = NO_LINE;
+  for (auto &instruction : theProgram.getInstructions())
+  {
+    if (Instruction::OpCode::Declare != instruction.getOpCode() &&
+        Instruction::OpCode::Halt != instruction.getOpCode() &&
+        myProfileIndex.emplace(instruction.getLine(),
+                               myProfileLines.size()).second)
+    {
+      myProfileLines.push_back(instruction.getLine());
+    }
+  }
+  myProfileCounted.assign(myProfileLines.size(), false);
+
+  // The return address leaves the stack 8 bytes off 16 byte alignment;
+  // the saved registers and the frame must put it back for calls.
+  uint32_t saved = 0;
+  for (auto reg = SCRATCH_COUNT; reg < REGISTER_COUNT; ++reg)
+  {
+    saved += myAllocator.isUsed(reg) ? 1 : 0;
+  }
+  myFrameSize = 8 * myAllocator.getStackSlotCount();
+  if (0 == (8 * saved + myFrameSize) % 16)
+  {
+    myFrameSize += 8;
+  }
+
+  theSink.write("\t.text\n"
+                "\t.globl\tmain\n"
+                "\t.type\tmain, @function\n"
+                "main:\n");
+  for (auto reg = SCRATCH_COUNT; reg < REGISTER_COUNT; ++reg)
+  {
+    if (myAllocator.isUsed(reg))
+    {
+      write("pushq", REGISTERS[reg]);
+    }
+  }
+  if (0 != myFrameSize)
+  {
+    write("subq", "$" + std::to_string(myFrameSize) + ", %rsp");
+  }
+  if (myChecked)
+  {
+    write("leaq", "main(%rip), %rdi");
+    write("leaq", ".Ltraps(%rip), %rsi");
+    write("movl", "$.Ltrap_count, %edx");
+    write("movq", "micro_overflow@GOTPCREL(%rip), %rcx");
+    write("call", "micro_trap_overflows@PLT");
+  }
+
+  auto &instructions = theProgram.getInstructions();
+  for (uint32_t ii = 0; ii < instructions.size(); ++ii)
+  {
+    emitInstruction(ii);
+  }
+  if (instructions.empty() ||
+      Instruction::OpCode::Halt != instructions.back().getOpCode())
+  {
+    emitReturn();
+  }
+
+  theSink.write("\t.size\tmain, .-main\n");
+  if (myChecked)
+  {
+    emitTrapData();
+  }
+  if (CompilerOptions::Instrument::None != myInstrument)
+  {
+    emitProfileData();
+  }
+  theSink.write("\t.section\t.note.GNU-stack,\"\",@progbits\n");
+
+  theStatistics.add("values spilled", myAllocator.getSpillCount());
+  theStatistics.add("stack slots", myAllocator.getStackSlotCount());
+  myProgram = nullptr;
+  mySink = nullptr;
+  mySSA = nullptr;
+}
+
+//**************************************************
+// X86Backend::emitInstruction
+//**************************************************
+void X86Backend::emitInstruction(uint32_t theInstruction)
+{
+  auto &instruction = myProgram->getInstructions()[theInstruction];
+  std::string text;
+  TextBackend::format(*myProgram, instruction, text);
+  mySink->write("\t# " + text + "\n");
+  if (CompilerOptions::Instrument::None != myInstrument)
+  {
+    emitProfile(theInstruction);
+  }
+
+  switch (instruction.getOpCode())
+  {
+    case Instruction::OpCode::Declare:
+      break;
+
+    case Instruction::OpCode::Read:
+      write("call", "micro_read@PLT");
+      write("movq", "%rax, " + operand(theInstruction, 0));
+      break;
+
+    case Instruction::OpCode::Write:
+      load(theInstruction, 0, "%rdi");
+      write("call", "micro_write@PLT");
+      break;
+
+    case Instruction::OpCode::Store:
+    {
+      auto destination = operand(theInstruction, 1);
+      if ('%' == destination[0])
+      {
+        load(theInstruction, 0, destination);
+      }
+      else if (isWideLiteral(theInstruction, 0) ||
+               '%' != operand(theInstruction, 0)[0])
+      {
+        // No memory to memory moves, nor 64 bit immediates to memory.
+        load(theInstruction, 0, "%rax");
+        write("movq", "%rax, " + destination);
+      }
+      else
+      {
+        write("movq", operand(theInstruction, 0) + ", " + destination);
+      }
+    }
+    break;
+
+    case Instruction::OpCode::Add:
+    case Instruction::OpCode::Sub:
+    case Instruction::OpCode::Mul:
+    {
+      auto opCode = instruction.getOpCode();
+      auto destination = operand(theInstruction, 2);
+      uint32_t left = 0;
+      uint32_t right = 1;
+      if (Instruction::OpCode::Sub != opCode &&
+          destination == operand(theInstruction, 1))
+      {
+        std::swap(left, right);
+      }
+
+      // Computed in place when the destination is a register not holding
+      // the right operand (which would be overwritten before it's read).
+      auto target = ('%' == destination[0] &&
+                     destination != operand(theInstruction, right)) ?
+        destination : std::string("%rax");
+      auto rightText = operand(theInstruction, right);
+      if (isWideLiteral(theInstruction, right))
+      {
+        load(theInstruction, right, "%rdx");
+        rightText = "%rdx";
+      }
+      load(theInstruction, left, target);
+      write(Instruction::OpCode::Add == opCode ? "addq" :
+            Instruction::OpCode::Sub == opCode ? "subq" : "imulq",
+            rightText + ", " + target);
+      if (myChecked)
+      {
+        write("jno", "1f");
+        mySink->write(trapLabel(myTrapLines.size()) + ":\n");
+        write("ud2");
+        mySink->write("1:\n");
+        myTrapLines.push_back(instruction.getLine());
+      }
+      if (target != destination)
+      {
+        write("movq", target + ", " + destination);
+      }
+    }
+    break;
+
+    case Instruction::OpCode::Pow:
+      // The base is moved out of the way first, in case it is in %rsi.
+      load(theInstruction, 0, "%rax");
+      load(theInstruction, 1, "%rsi");
+      write("movq", "%rax, %rdi");
+      if (myChecked)
+      {
+        write("movl", "$" + std::to_string(instruction.getLine()) + ", %edx");
+        write("call", "micro_power_checked@PLT");
+      }
+      else
+      {
+        write("call", "micro_power@PLT");
+      }
+      write("movq", "%rax, " + operand(theInstruction, 2));
+      break;
+
+    case Instruction::OpCode::Halt:
+      emitReturn();
+      break;
+  }
+}
+
+//**************************************************
+// X86Backend::emitProfile
+//**************************************************
+void X86Backend::emitProfile(uint32_t theInstruction)
+{
+  auto &instruction = myProgram->getInstructions()[theInstruction];
+  auto opCode = instruction.getOpCode();
+  if (Instruction::OpCode::Declare == opCode)
+  {
+    return;
+  }
+  auto line = (Instruction::OpCode::Halt == opCode) ? NO_LINE :
+    myProfileIndex[instruction.getLine()];
+  if (line == myProfileLine)
+  {
+    return;
+  }
+
+  if (CompilerOptions::Instrument::Cycles == myInstrument)
+  {
+    write("rdtsc");
+    write("shlq", "$32, %rdx");
+    write("orq", "%rdx, %rax");
+    if (NO_LINE != myProfileLine)
+    {
+      write("movq", "%rax, %rdx");
+      write("subq", ".Lprofile_start(%rip), %rax");
+      write("addq", "%rax, .Lprofile_cycles+" +
+            std::to_string(8 * myProfileLine) + "(%rip)");
+      write("movq", "%rdx, .Lprofile_start(%rip)");
+    }
+    else
+    {
+      write("movq", "%rax, .Lprofile_start(%rip)");
+    }
+  }
+  myProfileLine = line;
+
+  if (NO_LINE != line && ! myProfileCounted[line])
+  {
+    // Code is straight line, so a line's first code runs once per run.
+    myProfileCounted[line] = true;
+    write("incq", ".Lprofile_counts+" + std::to_string(8 * line) + "(%rip)");
+  }
+
+  if (Instruction::OpCode::Halt == opCode)
+  {
+    write("leaq", ".Lprofile_source(%rip), %rdi");
+    write("leaq", ".Lprofile_lines(%rip), %rsi");
+    write("leaq", ".Lprofile_counts(%rip), %rdx");
+    if (CompilerOptions::Instrument::Cycles == myInstrument)
+    {
+      write("leaq", ".Lprofile_cycles(%rip), %rcx");
+    }
+    else
+    {
+      write("xorl", "%ecx, %ecx");
+    }
+    write("movl", "$" + std::to_string(myProfileLines.size()) + ", %r8d");
+    write("call", "micro_profile_write@PLT");
+  }
+}
+
+//**************************************************
+// X86Backend::emitProfileData
+//**************************************************
+void X86Backend::emitProfileData()
+{
+  std::string source;
+  for (unsigned char c : mySource)
+  {
+    if ('"' == c || '\\' == c)
+    {
+      source.push_back('\\');
+      source.push_back(c);
+    }
+    else if (c < ' ' || c > '~')
+    {
+      char octal[5];
+      std::snprintf(octal, sizeof(octal), "\\%03o", c);
+      source += octal;
+    }
+    else
+    {
+      source.push_back(c);
+    }
+  }
+
+  auto size = std::to_string(8 * myProfileLines.size());
+  mySink->write("\t.section\t.rodata\n"
+                "\t.p2align\t2\n"
+                ".Lprofile_lines:\n");
+  for (auto line : myProfileLines)
+  {
+    write(".long", std::to_string(line));
+  }
+  mySink->write(".Lprofile_source:\n");
+  write(".string", "\"" + source + "\"");
+  mySink->write("\t.bss\n"
+                "\t.p2align\t3\n"
+                ".Lprofile_counts:\n");
+  if (! myProfileLines.empty())
+  {
+    write(".zero", size);
+  }
+  if (CompilerOptions::Instrument::Cycles == myInstrument)
+  {
+    mySink->write(".Lprofile_cycles:\n");
+    if (! myProfileLines.empty())
+    {
+      write(".zero", size);
+    }
+    mySink->write(".Lprofile_start:\n");
+    write(".zero", "8");
+  }
+}
+
+//**************************************************
+// X86Backend::emitReturn
+//**************************************************
+void X86Backend::emitReturn()
+{
+  if (0 != myFrameSize)
+  {
+    write("addq", "$" + std::to_string(myFrameSize) + ", %rsp");
+  }
+  for (auto reg = REGISTER_COUNT; reg-- > SCRATCH_COUNT; )
+  {
+    if (myAllocator.isUsed(reg))
+    {
+      write("popq", REGISTERS[reg]);
+    }
+  }
+  write("xorl", "%eax, %eax");
+  write("ret");
+}
+
+//**************************************************
+// X86Backend::emitTrapData
+//**************************************************
+void X86Backend::emitTrapData()
+{
+  // Pairs of a trap's offset in main and its line (see Runtime.h).
+  mySink->write("\t.section\t.rodata\n"
+                "\t.p2align\t2\n"
+                ".Ltraps:\n");
+  for (uint32_t ii = 0; ii < myTrapLines.size(); ++ii)
+  {
+    write(".long", trapLabel(ii) + "-main, " +
+          std::to_string(myTrapLines[ii]));
+  }
+  write(".set", ".Ltrap_count, " + std::to_string(myTrapLines.size()));
+}
+
+//**************************************************
+// X86Backend::isCall
+//**************************************************
+bool X86Backend::isCall(const Instruction &theInstruction) noexcept
+{
+  switch (theInstruction.getOpCode())
+  {
+    case Instruction::OpCode::Read:
+    case Instruction::OpCode::Write:
+    case Instruction::OpCode::Pow:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+//**************************************************
+// X86Backend::isWideLiteral
+//**************************************************
+bool X86Backend::isWideLiteral(uint32_t theInstruction,
+                               uint32_t theOperand) const
+{
+  auto &source =
+    myProgram->getInstructions()[theInstruction].getOperand(theOperand);
+  return Operand::Kind::Literal == source.getKind() &&
+    (source.getValue() < INT32_MIN || source.getValue() > INT32_MAX);
+}
+
+//**************************************************
+// X86Backend::load
+//**************************************************
+void X86Backend::load(uint32_t theInstruction, uint32_t theOperand,
+                      const std::string &theRegister)
+{
+  auto source = operand(theInstruction, theOperand);
+  if (isWideLiteral(theInstruction, theOperand))
+  {
+    write("movabsq", source + ", " + theRegister);
+  }
+  else if (source != theRegister)
+  {
+    write("movq", source + ", " + theRegister);
+  }
+}
+
+//**************************************************
+// X86Backend::operand
+//**************************************************
+std::string X86Backend::operand(uint32_t theInstruction,
+                                uint32_t theOperand) const
+{
+  auto &instruction = myProgram->getInstructions()[theInstruction];
+  auto &source = instruction.getOperand(theOperand);
+  if (Operand::Kind::Literal == source.getKind())
+  {
+    return "$" + std::to_string(source.getValue());
+  }
+
+  auto value = (instruction.getSourceCount() == theOperand) ?
+    mySSA->getDefinition(theInstruction) :
+    mySSA->getValue(theInstruction, theOperand);
+  auto &location = myAllocator.getLocation(value);
+  switch (location.myKind)
+  {
+    case LinearScanAllocator::Location::Kind::Register:
+      return REGISTERS[location.myIndex];
+
+    case LinearScanAllocator::Location::Kind::Stack:
+      return std::to_string(8 * location.myIndex) + "(%rsp)";
+
+    case LinearScanAllocator::Location::Kind::None:
+      break;
+  }
+  // Never assigned: variables start out as 0.
+  return "$0";
+}
+
+//**************************************************
+// X86Backend::trapLabel
+//**************************************************
+std::string X86Backend::trapLabel(uint32_t theTrap)
+{
+  return ".Ltrap_" + std::to_string(theTrap);
+}
+
+//**************************************************
+// X86Backend::write
+//**************************************************
+void X86Backend::write(const char *theMnemonic,
+                       const std::string &theOperands)
+{
+  std::string line("\t");
+  line += theMnemonic;
+  if (! theOperands.empty())
+  {
+    line += "\t" + theOperands;
+  }
+  line.push_back('\n');
+  mySink->write(line);
+}
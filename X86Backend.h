@@ -0,0 +1,270 @@
+#ifndef X86BACKEND_H
+#define X86BACKEND_H
+
+/**
+ * @file X86Backend.h
+ * @brief Defines the class which writes programs as x86-64 assembly.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "CompilerOptions.h"
+#include "LinearScanAllocator.h"
+
+class Instruction;
+class OutputSink;
+class Program;
+class SSAForm;
+class Statistics;
+
+/**
+ * Writes a program as GNU as x86-64 assembly for Linux (System V ABI). The
+ * program becomes the function main, to be linked with the runtime library
+ * (see Runtime.h) which implements Read, Write and exponentiation:
+ *
+ *   MicroCompiler -q -t x86-64 -o prog.s prog.mc
+ *   g++ -o prog prog.s libMicroRuntime.a
+ *
+ * Values are kept in registers by linear scan allocation, spilling to the
+ * stack frame when they run out. %rax and %rdx are never allocated; they
+ * hold intermediate results and arguments.
+ *
+ * Checked code (--checked) follows each add, sub and imul with a jno over a
+ * ud2, which traps on overflow. main starts by passing a table of the
+ * traps' lines (in .rodata) to micro_trap_overflows, which turns a trap
+ * into a call of micro_overflow with its line.
+ *
+ * Instrumented code (--instrument) counts the runs of each source line, and
+ * optionally times them: at each change of line, rdtsc is read and the
+ * cycles since the last change are added to the line being left. The
+ * counters live in .bss and are written out by micro_profile_write on
+ * Halt. Only %rax and %rdx are used, so allocation is unaffected.
+ */
+class X86Backend
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor.
+   */
+  X86Backend() = delete;
+
+  /**
+   * Constructor.
+   *
+   * @param theChecked
+   *          stop on signed overflow (rather than wrap)?
+   * @param theInstrument
+   *          profiling instrumentation
+   * @param theSource
+   *          source file (named in the profile)
+   */
+  X86Backend(bool theChecked, CompilerOptions::Instrument theInstrument,
+             const std::string &theSource);
+
+  /**
+   * Copy constructor
+   */
+  X86Backend(const X86Backend &) = delete;
+
+  /**
+   * Move constructor
+   */
+  X86Backend(X86Backend &&) = delete;
+
+  /**
+   * Destructor
+   */
+  ~X86Backend() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  X86Backend& operator=(const X86Backend &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  X86Backend& operator=(X86Backend &&) = delete;
+
+  /**
+   * Writes the program.
+   *
+   * @param theProgram
+   *          program to write
+   * @param theSink
+   *          destination
+   * @param theStatistics
+   *          statistics to add to
+   */
+  void emit(const Program &theProgram, OutputSink &theSink,
+            Statistics &theStatistics);
+
+  /**
+   * Returns if an instruction is implemented by a call into the runtime.
+   *
+   * @param theInstruction
+   *          instruction
+   * @return true if it is a call
+   */
+  static bool isCall(const Instruction &theInstruction) noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Allocatable registers, those clobbered by calls first. */
+  static const char* const REGISTERS[];
+
+  /** Number of allocatable registers. */
+  static constexpr uint32_t REGISTER_COUNT = 13;
+
+  /** Number of allocatable registers clobbered by calls. */
+  static constexpr uint32_t SCRATCH_COUNT = 7;
+
+  /** Profile line index of no line. */
+  static constexpr uint32_t NO_LINE = UINT32_MAX;
+
+  /**
+   * Writes the code for one instruction.
+   *
+   * @param theInstruction
+   *          instruction index
+   */
+  void emitInstruction(uint32_t theInstruction);
+
+  /**
+   * Writes the profiling code needed before an instruction: moving to its
+   * line's counters, and writing the profile on Halt.
+   *
+   * @param theInstruction
+   *          instruction index
+   */
+  void emitProfile(uint32_t theInstruction);
+
+  /**
+   * Writes the profile counters and line table.
+   */
+  void emitProfileData();
+
+  /**
+   * Writes the code to leave main.
+   */
+  void emitReturn();
+
+  /**
+   * Writes the table of overflow traps (checked code).
+   */
+  void emitTrapData();
+
+  /**
+   * Returns if a source operand is a literal which doesn't fit in a sign
+   * extended 32 bit immediate.
+   *
+   * @param theInstruction
+   *          instruction index
+   * @param theOperand
+   *          source operand index
+   * @return true if it must be loaded with movabsq
+   */
+  bool isWideLiteral(uint32_t theInstruction, uint32_t theOperand) const;
+
+  /**
+   * Writes code loading a source operand into a register.
+   *
+   * @param theInstruction
+   *          instruction index
+   * @param theOperand
+   *          source operand index
+   * @param theRegister
+   *          register (e.g., "%rax")
+   */
+  void load(uint32_t theInstruction, uint32_t theOperand,
+            const std::string &theRegister);
+
+  /**
+   * Returns the assembly text of an operand: a register, a stack slot or an
+   * immediate.
+   *
+   * @param theInstruction
+   *          instruction index
+   * @param theOperand
+   *          operand index
+   * @return operand text
+   */
+  std::string operand(uint32_t theInstruction, uint32_t theOperand) const;
+
+  /**
+   * Returns the label of an overflow trap.
+   *
+   * @param theTrap
+   *          trap number
+   * @return label
+   */
+  static std::string trapLabel(uint32_t theTrap);
+
+  /**
+   * Writes one line of code.
+   *
+   * @param theMnemonic
+   *          mnemonic
+   * @param theOperands
+   *          operands, comma separated
+   */
+  void write(const char *theMnemonic, const std::string &theOperands = "");
+
+  /** Allocation of the current program. */
+  LinearScanAllocator myAllocator;
+
+  /** Stop on signed overflow? */
+  bool myChecked;
+
+  /** Profiling instrumentation. */
+  CompilerOptions::Instrument myInstrument;
+
+  /** Size of the stack frame, in bytes. */
+  uint32_t myFrameSize = 0;
+
+  /** Profiled lines have been counted (instrumented code)? */
+  std::vector<bool> myProfileCounted;
+
+  /** Index of each profiled line in myProfileLines. */
+  std::map<uint32_t, uint32_t> myProfileIndex;
+
+  /** Profiled source lines, in the order of their first code. */
+  std::vector<uint32_t> myProfileLines;
+
+  /** Index of the line being run (instrumented code), or NO_LINE. */
+  uint32_t myProfileLine = NO_LINE;
+
+  /** Program being written. */
+  const Program *myProgram = nullptr;
+
+  /** Destination of the code. */
+  OutputSink *mySink = nullptr;
+
+  /** Source file. */
+  std::string mySource;
+
+  /** SSA form of the program being written. */
+  const SSAForm *mySSA = nullptr;
+
+  /** Source line of each overflow trap (checked code). */
+  std::vector<uint32_t> myTrapLines;
+};
+
+#endif
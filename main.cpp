@@ -6,29 +6,130 @@
  */
 
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include <unistd.h>
 
 #include "CodeGenerator.h"
+#include "CompilerOptions.h"
 #include "ErrorWarningTracker.h"
+#include "FileDescriptorSink.h"
+#include "JitBackend.h"
+#include "MemorySink.h"
+#include "NullSink.h"
+#include "ObjectFile.h"
 #include "Scanner.h"
 #include "Parser.h"
+#include "Runtime.h"
+#include "VirtualMachine.h"
 
 int main(int argc, char **argv)
 {
   try
   {
-    if (argc == 1)
+    CompilerOptions options(argc, argv);
+    std::string file(options.getInputFile());
+
+    // A compiled program (see --emit-object) is run as it is.
+    if (ObjectFile::isObject(file))
     {
-      throw std::runtime_error("No input file provided.");
+      ObjectFile object(file);
+      auto &header = object.getHeader();
+      if (object.isOutOfDate())
+      {
+        std::cerr << file << ": warning: '" << object.getSource()
+                  << "' has changed since it was compiled" << std::endl;
+      }
+      switch (options.getExecution())
+      {
+        case CompilerOptions::Execution::None:
+        case CompilerOptions::Execution::Vm:
+        {
+          VirtualMachine vm;
+          vm.run(object.getOperations(), object.getConstants(),
+                 header.myConstantCount, header.myConstantBase,
+                 object.getLines());
+        }
+        break;
+
+        case CompilerOptions::Execution::Jit:
+          if (nullptr == object.getNativeCode())
+          {
+            throw std::runtime_error("'" + file + "' has no native code.");
+          }
+          JitBackend::run(object.getNativeCode(), object.getTraps(),
+                          header.myTrapCount, header.myConstantBase,
+                          JitBackend::getRuntimeCallbacks());
+          break;
+
+        default:
+          throw std::runtime_error(
+            "Object files are run with -x vm or -x jit.");
+      }
+      micro_flush();
+      return 0;
     }
 
-    std::string file(argv[1]);
+    // When tracing to stdout the code is collected and printed after the
+    // trace, otherwise it is streamed straight to its destination.
+    std::unique_ptr<OutputSink> sink;
+    MemorySink *codeListing = nullptr;
+    bool executing =
+      (CompilerOptions::Execution::None != options.getExecution());
+    if (options.isCheckOnly() ||
+        (executing && options.getOutputFile().empty()))
+    {
+      sink.reset(new NullSink());
+    }
+    else if (! options.getOutputFile().empty())
+    {
+      sink.reset(new FileDescriptorSink(options.getOutputFile()));
+    }
+    else if (options.isTraceEnabled())
+    {
+      codeListing = new MemorySink();
+      sink.reset(codeListing);
+    }
+    else
+    {
+      sink.reset(new FileDescriptorSink(STDOUT_FILENO));
+    }
 
     ErrorWarningTracker ewTracker(file);
-    CodeGenerator codeGenerator(ewTracker);
+    CodeGenerator codeGenerator(*sink, ewTracker, options);
 
     Scanner scanner(file);
-    Parser parser(scanner, codeGenerator, ewTracker);
+    Parser parser(scanner, codeGenerator, ewTracker, options);
     parser.parse();
+    sink->flush();
+
+    if (executing && ! ewTracker.hasError())
+    {
+      codeGenerator.execute();
+    }
+
+    if (options.isStatisticsEnabled())
+    {
+      std::cerr << "Statistics" << std::endl
+                << "----------" << std::endl;
+      codeGenerator.getStatistics().print(std::cerr);
+    }
+
+    if (options.isPassStatisticsEnabled())
+    {
+      std::cerr << "Pass Statistics" << std::endl
+                << "---------------" << std::endl;
+      codeGenerator.getPassManager().print(std::cerr);
+    }
+
+    if (nullptr != codeListing)
+    {
+      std::cout << std::endl
+                << "Complete Code" << std::endl
+                << "-------------" << std::endl
+                << codeListing->getContents();
+    }
   }
   catch (const std::exception &exception)
   {
@@ -0,0 +1,382 @@
+#!/bin/sh
+#
+# Benchmarks the parts of the compiler whose cost grows with the size of
+# the program, and the ways of running a program, on large generated
+# programs. Micro has no loops, so a program's run time is proportional to
+# its length; the programs are straight-line code over 64 variables and 8
+# inputs, mixing +, -, ** 2 and write.
+#
+# Run times are of one run, from its start to Halt, without compiling or
+# starting a process: -x vm, jit and batch report theirs in the "run time
+# (us)" statistic, as testCode/interpret -s does for text code, and
+# executables (-t x86-64 and c) are linked with a main which times a call
+# of the program's own main. Each time is the median of RUNS runs: a single
+# run of straight-line code is cold, and its time varies by a third from
+# one run to the next. (-x batch's time is of every record, reading and
+# writing included.)
+#
+# Usage: bench.sh COMPILER RUNTIME_LIBRARY [SECTION...]
+#
+#   symbols     symbol table look ups against the number of symbols
+#   c           -t c (built with $CC -O2) against -t x86-64
+#   execution   text code, -x vm (with and without superinstructions),
+#               -x jit and -t x86-64
+#   batch       -x batch throughput
+#   checked     cost of --checked
+#   instrument  cost of --instrument
+#   evaluation  compile time evaluation of a program without Read
+#
+# (Default all.) Code from the tree is built with $CXX -O2. The compiler's
+# own optimization matters too, -x vm and jit running in it: build with
+# make CFLAGS='--std=c++11 -O2' for figures worth comparing.
+
+COMPILER=$1
+RUNTIME=$2
+shift 2
+SECTIONS=${*:-symbols c execution batch checked instrument evaluation}
+STATEMENTS=${STATEMENTS:-200000}
+C_STATEMENTS=${C_STATEMENTS:-50000}
+RUNS=${RUNS:-15}
+CC=${CC:-cc}
+CXX=${CXX:-g++}
+SOURCE=$(dirname "$0")/..
+
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+export MICRO_PROFILE="$WORK/profile"
+INPUT=$WORK/input
+echo "3 -4 5 1 -2 7 0 9" > "$INPUT"
+
+# Calls a program's main (renamed micro_program) and reports the time it
+# took as the compiler's -s does.
+cat > "$WORK/timer.c" <<'EOF'
+#include <stdio.h>
+#include <time.h>
+
+int micro_program(void);
+
+int main(void)
+{
+  struct timespec start;
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  micro_program();
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  fprintf(stderr, "%12ld  run time (us)\n",
+          (long)((end.tv_sec - start.tv_sec) * 1000000 +
+                 (end.tv_nsec - start.tv_nsec) / 1000));
+  return 0;
+}
+EOF
+$CC -O2 -c -o "$WORK/timer.o" "$WORK/timer.c" || exit 1
+
+# generate STATEMENTS [assigned] > FILE: writes a program (which reads its
+# inputs, or with "assigned" assigns them).
+generate()
+{
+  awk -v statements="$1" -v assigned="$2" 'BEGIN {
+    srand(5640);
+    print "begin";
+    if (assigned)
+      for (i = 0; i < 8; ++i)
+        printf "  R%d := %d;\n", i, i * 3 + 1;
+    else
+      print "  read(R0, R1, R2, R3, R4, R5, R6, R7);";
+    for (s = 0; s < statements; ++s)
+    {
+      i = int(rand() * 64); j = int(rand() * 64);
+      k = int(rand() * 8); l = int(rand() * 8); c = int(rand() * 100);
+      r = rand();
+      if (r < 0.4)
+        printf "  V%d := V%d + R%d - %d;\n", i, j, k, c;
+      else if (r < 0.7)
+        printf "  V%d := R%d - V%d + %d;\n", i, k, j, c;
+      else if (r < 0.9)
+        printf "  V%d := V%d + (R%d - R%d) ** 2;\n", i, j, k, l;
+      else
+        printf "  write(V%d);\n", i;
+    }
+    print "end";
+  }'
+}
+
+# now: prints the time in microseconds.
+now()
+{
+  echo $(($(date +%s%N) / 1000))
+}
+
+# median: prints the median of the numbers read, one per line.
+median()
+{
+  sort -n | awk '{ times[NR] = $1 } END { print times[int((NR + 1) / 2)] }'
+}
+
+# repeat COMMAND...: prints the median of what the command prints.
+repeat()
+{
+  run=0
+  while [ $run -lt "$RUNS" ]; do
+    "$@"
+    run=$((run + 1))
+  done | median
+}
+
+# elapsed COMMAND...: prints the median wall time of the command (us).
+elapsed()
+{
+  run=0
+  while [ $run -lt "$RUNS" ]; do
+    start=$(now)
+    "$@" < "$INPUT" > /dev/null 2>&1
+    echo $(($(now) - start))
+    run=$((run + 1))
+  done | median
+}
+
+# runTime COMMAND...: prints the median "run time (us)" of the command
+# (run with -s).
+runTime()
+{
+  run=0
+  while [ $run -lt "$RUNS" ]; do
+    "$@" -s < "$INPUT" 2>&1 > /dev/null |
+      awk '/ run time \(us\)$/ { print $1 }'
+    run=$((run + 1))
+  done | median
+}
+
+# native FILE OPTIONS...: builds $WORK/native from -t x86-64 output (left
+# in $WORK/native.s).
+native()
+{
+  file=$1
+  shift
+  "$COMPILER" -q "$@" -t x86-64 -o "$WORK/native.s" "$file" && link
+}
+
+# link: builds $WORK/native from $WORK/native.s.
+link()
+{
+  $CXX -c -o "$WORK/native.o" "$WORK/native.s" &&
+    objcopy --redefine-sym main=micro_program "$WORK/native.o" &&
+    $CXX -o "$WORK/native" "$WORK/timer.o" "$WORK/native.o" "$RUNTIME"
+}
+
+# c FILE: builds $WORK/c from -t c output, setting build to the time $CC
+# took.
+c()
+{
+  "$COMPILER" -q -t c -o "$WORK/program.c" "$1" || return
+  start=$(now)
+  $CC -O2 -Dmain=micro_program -c -o "$WORK/c.o" "$WORK/program.c" &&
+    $CC -o "$WORK/c" "$WORK/timer.o" "$WORK/c.o"
+  build=$(($(now) - start))
+}
+
+# report LABEL TIME [BASE]: prints a time, and its ratio to a base time.
+report()
+{
+  if [ -n "$3" ] && [ "$3" -gt 0 ]; then
+    printf "  %-44s %9d us %7s%%\n" "$1" "$2" $(($2 * 100 / $3))
+  else
+    printf "  %-44s %9d us\n" "$1" "$2"
+  fi
+}
+
+for section in $SECTIONS; do
+  case $section in
+    symbols)
+      # Looks up N distinct identifiers as the code generator does: the
+      # first use of each declares it, and each is used three times more.
+      # Prints the time taken per symbol (ns), hashing included, in the
+      # symbol table or (with "linear") a vector searched with std::find,
+      # as the code generator used to do.
+      cat > "$WORK/symbols.cpp" <<'EOF'
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "SymbolTable.h"
+#include "Token.h"
+
+int main(int argc, char **argv)
+{
+  int count = std::atoi(argv[1]);
+  bool linear = (argc > 2);
+  std::vector<std::string> names;
+  for (int i = 0; i < count; ++i)
+  {
+    names.push_back("V" + std::to_string(i));
+  }
+
+  SymbolTable table;
+  std::vector<std::string> vector;
+  uint64_t found = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int use = 0; use < 4; ++use)
+  {
+    for (const auto &name : names)
+    {
+      if (linear)
+      {
+        auto symbol = std::find(vector.begin(), vector.end(), name);
+        if (vector.end() == symbol)
+        {
+          vector.push_back(name);
+        }
+        else
+        {
+          found += symbol - vector.begin();
+        }
+      }
+      else
+      {
+        uint64_t hash = Token::hash(name);
+        uint32_t symbol = table.find(name, hash);
+        if (SymbolTable::NOT_FOUND == symbol)
+        {
+          table.insert(name, hash);
+        }
+        else
+        {
+          found += symbol;
+        }
+      }
+    }
+  }
+  auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - start);
+  std::printf("%lld\n", static_cast<long long>(time.count() / count));
+  return (found == 0);
+}
+EOF
+      $CXX --std=c++11 -O2 -I"$SOURCE" -o "$WORK/symbols" \
+        "$WORK/symbols.cpp" "$SOURCE/SymbolTable.cpp" "$SOURCE/Token.cpp" ||
+        exit 1
+      echo "Symbol look up time against distinct symbols:"
+      printf "  %8s %12s %12s\n" symbols table linear
+      for count in 6250 12500 25000 50000 100000; do
+        printf "  %8d %9d ns" $count $(repeat "$WORK/symbols" $count)
+        # (The linear search is quadratic: 100000 symbols take minutes.)
+        if [ $count -le 25000 ]; then
+          printf " %9d ns" $(repeat "$WORK/symbols" $count linear)
+        fi
+        echo
+      done
+      ;;
+
+    c)
+      echo "Run time, $C_STATEMENTS statements:"
+      generate "$C_STATEMENTS" > "$WORK/program.mc"
+      native "$WORK/program.mc"
+      x86=$(runTime "$WORK/native")
+      report "-t x86-64" $x86
+      c "$WORK/program.mc"
+      report "-t c, $CC -O2" $(runTime "$WORK/c") $x86
+      report "($CC -O2 build time)" $build
+      ;;
+
+    execution)
+      echo "Run time, $STATEMENTS statements:"
+      generate "$STATEMENTS" > "$WORK/program.mc"
+      $CXX --std=c++11 -O2 -o "$WORK/interpret" \
+        "$SOURCE/testCode/interpret.cpp" || exit 1
+      "$COMPILER" -q -o "$WORK/program.txt" "$WORK/program.mc"
+      vm=$(runTime "$COMPILER" -q -x vm "$WORK/program.mc")
+      report "-x vm" $vm
+      report "-x vm --no-superinstructions" \
+        $(runTime "$COMPILER" -q -x vm --no-superinstructions \
+          "$WORK/program.mc") $vm
+      report "text, testCode/interpret" \
+        $(runTime "$WORK/interpret" "$WORK/program.txt") $vm
+      report "-x jit" $(runTime "$COMPILER" -q -x jit "$WORK/program.mc") $vm
+      native "$WORK/program.mc"
+      report "-t x86-64" $(runTime "$WORK/native") $vm
+      ;;
+
+    batch)
+      echo "Batch throughput, 50 statements, 1000000 records:"
+      generate 50 > "$WORK/batch.mc"
+      awk 'BEGIN {
+        for (i = 0; i < 1000000; ++i)
+          printf "%d,%d,%d,%d,%d,%d,%d,%d\n", i % 7, -(i % 5), i % 3, 1,
+            i % 11 - 5, 2, -(i % 9), i % 4;
+      }' > "$WORK/records"
+      input=$INPUT
+      INPUT=$WORK/records
+      time=$(runTime "$COMPILER" -q -x batch "$WORK/batch.mc")
+      INPUT=$input
+      report "-x batch" $time
+      printf "  %-44s %9d ns\n" "per record" $((time / 1000))
+      ;;
+
+    checked)
+      echo "Cost of --checked, $STATEMENTS statements:"
+      generate "$STATEMENTS" > "$WORK/program.mc"
+      # (--checked implies --preserve-order.)
+      for mode in vm jit; do
+        plain=$(runTime "$COMPILER" -q -x $mode --preserve-order \
+                  "$WORK/program.mc")
+        report "-x $mode --preserve-order" $plain
+        report "-x $mode --checked" \
+          $(runTime "$COMPILER" -q -x $mode --checked "$WORK/program.mc") \
+          $plain
+      done
+      native "$WORK/program.mc" --preserve-order
+      plain=$(runTime "$WORK/native")
+      report "-t x86-64 --preserve-order" $plain
+      native "$WORK/program.mc" --checked
+      report "-t x86-64 --checked" $(runTime "$WORK/native") $plain
+      ;;
+
+    instrument)
+      echo "Cost of --instrument, $STATEMENTS statements:"
+      generate "$STATEMENTS" > "$WORK/program.mc"
+      native "$WORK/program.mc"
+      plain=$(runTime "$WORK/native")
+      report "-t x86-64" $plain
+      # Halt writes the profile, adding in the last run's; the time is
+      # also given with it written to /dev/null, and with the call which
+      # writes it taken out (the cost of counting alone).
+      for instrument in --instrument --instrument=cycles; do
+        native "$WORK/program.mc" $instrument
+        report "-t x86-64 $instrument" $(runTime "$WORK/native") $plain
+        report "-t x86-64 $instrument, to /dev/null" \
+          $(export MICRO_PROFILE=/dev/null; runTime "$WORK/native") $plain
+        sed '/micro_profile_write/d' "$WORK/native.s" > "$WORK/counting.s"
+        mv "$WORK/counting.s" "$WORK/native.s"
+        link
+        report "-t x86-64 $instrument, not written" \
+          $(runTime "$WORK/native") $plain
+      done
+      ;;
+
+    evaluation)
+      echo "Compile and run, $STATEMENTS statements without Read:"
+      generate "$STATEMENTS" assigned > "$WORK/program.mc"
+      plain=$(elapsed "$COMPILER" -q -x vm --disable=evaluation \
+                "$WORK/program.mc")
+      report "-x vm --disable=evaluation" $plain
+      report "-x vm" $(elapsed "$COMPILER" -q -x vm "$WORK/program.mc") \
+        $plain
+      plain=$(runTime "$COMPILER" -q -x vm --disable=evaluation \
+                "$WORK/program.mc")
+      report "(run time) -x vm --disable=evaluation" $plain
+      report "(run time) -x vm" \
+        $(runTime "$COMPILER" -q -x vm "$WORK/program.mc") $plain
+      printf "  %-44s %9d\n" "instructions, --disable=evaluation" \
+        $("$COMPILER" -q --disable=evaluation "$WORK/program.mc" | wc -l)
+      printf "  %-44s %9d\n" "instructions" \
+        $("$COMPILER" -q "$WORK/program.mc" | wc -l)
+      ;;
+
+    *)
+      echo "Unknown section '$section'." >&2
+      exit 1
+      ;;
+  esac
+done
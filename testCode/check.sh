@@ -0,0 +1,183 @@
+#!/bin/sh
+#
+# Runs each program in testCode/check every way it can be run (as text
+# code with and without optimization passes, each -x mode, from an object
+# file, and built from x86-64 and C output) and compares what it does with
+# what's expected:
+#
+#   NAME.mc           program
+#   NAME.in           its input (none if missing)
+#   NAME.out          expected output
+#   NAME.err          expected error output; if present the program must
+#                     fail (exit status 1), otherwise it must succeed
+#   NAME.flags        compiler options for every run (e.g. --checked)
+#   NAME.stats        lines the compiler must report with -s (statistics
+#                     and warnings, without the directory of the program)
+#   NAME.profile      profile expected from --instrument, less its first
+#                     line (which names the source file)
+#   NAME.records      input records for -x batch, and
+#   NAME.records.out  the output records expected (or NAME.records.err,
+#                     the compiler's error without its name)
+#
+# The expected files are written from the language's definition, not from
+# the compiler. Text code is run by INTERPRETER (testCode/interpret). The
+# C compiler ($CC, default cc) builds -t c output and the C++ compiler
+# ($CXX, default g++) links -t x86-64 output with the runtime library.
+#
+# Usage: check.sh COMPILER INTERPRETER RUNTIME_LIBRARY
+
+COMPILER=$1
+INTERPRETER=$2
+RUNTIME=$3
+CC=${CC:-cc}
+CXX=${CXX:-g++}
+DIR=$(dirname "$0")/check
+
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+export MICRO_PROFILE="$WORK/profile"
+
+passed=0
+failed=0
+
+# check NAME MODE EXPECTED_OUTPUT EXPECTED_ERROR STATUS
+#   Compares the run left in $WORK/stdout, $WORK/stderr and STATUS.
+check()
+{
+  if [ -f "$4" ]; then
+    expectedStatus=1
+  else
+    expectedStatus=0
+  fi
+  if [ "$5" -eq "$expectedStatus" ] &&
+     cmp -s "$3" "$WORK/stdout" &&
+     { [ ! -f "$4" ] || cmp -s "$4" "$WORK/stderr"; }; then
+    passed=$((passed + 1))
+  else
+    failed=$((failed + 1))
+    echo "FAIL: $1 ($2), exit status $5"
+    diff "$3" "$WORK/stdout" | sed 's/^/  /'
+    if [ -f "$4" ]; then
+      diff "$4" "$WORK/stderr" | sed 's/^/  /'
+    else
+      sed 's/^/  /' "$WORK/stderr"
+    fi
+  fi
+}
+
+# expect NAME MODE RESULT: counts a check which passed if RESULT is 0.
+expect()
+{
+  if [ "$3" -eq 0 ]; then
+    passed=$((passed + 1))
+  else
+    failed=$((failed + 1))
+    echo "FAIL: $1 ($2)"
+  fi
+}
+
+for program in "$DIR"/*.mc; do
+  name=$(basename "$program" .mc)
+  base=$DIR/$name
+  input=/dev/null
+  [ -f "$base.in" ] && input=$base.in
+  flags=
+  [ -f "$base.flags" ] && flags=$(cat "$base.flags")
+
+  # run MODE COMMAND...: runs a command on the program's input.
+  run()
+  {
+    mode=$1
+    shift
+    "$@" < "$input" > "$WORK/stdout" 2> "$WORK/stderr"
+    check "$name" "$mode" "$base.out" "$base.err" $?
+  }
+
+  # Text code can't stop on overflow, so a program which fails isn't run
+  # as text.
+  if [ ! -f "$base.err" ]; then
+    for mode in "" "-O0" "-O1" "-p" "-d copy-propagation" "-d peephole" \
+                "--keep-all" "--disable=evaluation"; do
+      rm -f "$WORK/code"
+      "$COMPILER" -q $flags $mode -o "$WORK/code" "$program" \
+        2> /dev/null
+      run "text $mode" "$INTERPRETER" "$WORK/code"
+    done
+  fi
+
+  # Code written to a file is what's written to stdout.
+  "$COMPILER" -q $flags -o "$WORK/code" "$program" 2> /dev/null
+  "$COMPILER" -q $flags "$program" > "$WORK/stdout" 2> /dev/null
+  cmp -s "$WORK/code" "$WORK/stdout"
+  expect "$name" "-o" $?
+
+  if [ -f "$base.stats" ]; then
+    "$COMPILER" -q -n -s $flags "$program" 2>&1 > /dev/null |
+      sed -e 's/^ *//' -e "s|^$DIR/||" > "$WORK/stats"
+    result=0
+    while read -r line; do
+      grep -q -x -F -e "$line" "$WORK/stats" || result=1
+    done < "$base.stats"
+    expect "$name" "-s" $result
+    if [ $result -ne 0 ]; then
+      sed 's/^/  /' "$WORK/stats"
+    fi
+  fi
+
+  for mode in "-x vm" "-x vm --no-superinstructions" "-x jit" \
+              "-O0 -x vm" "-O1 -x jit" "--keep-all -x vm" \
+              "--disable=evaluation -x jit"; do
+    run "$mode" "$COMPILER" -q $flags $mode "$program"
+  done
+
+  # (Anything left from the last program is removed, so a build which
+  # fails can't pass by running it.)
+  rm -f "$WORK/program.mco" "$WORK/native" "$WORK/c"
+  "$COMPILER" -q -n $flags --emit-object "$WORK/program.mco" "$program" \
+    2> /dev/null
+  run "object, -x vm" "$COMPILER" -q -x vm "$WORK/program.mco"
+  run "object, -x jit" "$COMPILER" -q -x jit "$WORK/program.mco"
+
+  "$COMPILER" -q $flags -t x86-64 -o "$WORK/program.s" "$program" \
+    2> /dev/null &&
+    $CXX -o "$WORK/native" "$WORK/program.s" "$RUNTIME"
+  run "-t x86-64" "$WORK/native"
+
+  for mode in --instrument=cycles --instrument; do
+    rm -f "$WORK/native" "$WORK/profile"
+    "$COMPILER" -q $flags -t x86-64 $mode -o "$WORK/program.s" \
+      "$program" 2> /dev/null &&
+      $CXX -o "$WORK/native" "$WORK/program.s" "$RUNTIME"
+    run "-t x86-64 $mode" "$WORK/native"
+  done
+  if [ -f "$base.profile" ]; then
+    tail -n +2 "$WORK/profile" 2> /dev/null | cmp -s "$base.profile" -
+    expect "$name" "profile" $?
+  fi
+
+  "$COMPILER" -q $flags -t c -o "$WORK/program.c" "$program" 2> /dev/null &&
+    $CC -O2 -Wall -Wextra -Werror -o "$WORK/c" "$WORK/program.c"
+  run "-t c" "$WORK/c"
+
+  if [ -f "$base.records" ]; then
+    "$COMPILER" -q $flags -x batch "$program" < "$base.records" \
+      > "$WORK/stdout" 2> "$WORK/errors"
+    status=$?
+    sed "s|^$COMPILER: ||" "$WORK/errors" > "$WORK/stderr"
+    check "$name" "-x batch" "$base.records.out" "$base.records.err" $status
+  fi
+done
+
+# An object file runs after its source changes, with a warning.
+printf 'begin\n  read(A);\n  write(A + 1);\nend\n' > "$WORK/stale.mc"
+"$COMPILER" -q -n --emit-object "$WORK/stale.mco" "$WORK/stale.mc"
+echo "-- changed" >> "$WORK/stale.mc"
+echo 41 | "$COMPILER" -q -x vm "$WORK/stale.mco" > "$WORK/stdout" \
+  2> "$WORK/stderr"
+warning="$WORK/stale.mco: warning: '$WORK/stale.mc' has changed since it"
+[ "$(cat "$WORK/stdout")" = 42 ] &&
+  [ "$(cat "$WORK/stderr")" = "$warning was compiled" ]
+expect stale "object, source changed" $?
+
+echo "$passed passed, $failed failed"
+[ "$failed" -eq 0 ]
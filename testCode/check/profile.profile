@@ -0,0 +1,6 @@
+# line runs
+3 1
+4 1
+5 1
+7 1
+8 1
@@ -0,0 +1,236 @@
+/**
+ * @file interpret.cpp
+ * @brief Runs the code MicroCompiler writes, for testing
+ *
+ * The code is run the way the text interpreter Micro's output was first
+ * run with does it: each line is parsed as it's reached, and variables are
+ * looked up by name. Arithmetic wraps in two's complement.
+ *
+ * Usage: interpret [-s] CODE_FILE
+ *
+ * -s reports the time taken to parse and run the code on stderr, as
+ * MicroCompiler -s reports run time.
+ *
+ * Read takes whitespace separated integers from stdin and Write writes one
+ * integer per line to stdout. A malformed line, a variable used before it's
+ * declared or missing input is an error (exit status 1).
+ *
+ * @author Michael Albers
+ */
+
+#include <cctype>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** Variables by name. */
+static std::unordered_map<std::string, int64_t> theVariables;
+
+//**************************************************
+// variable
+//**************************************************
+static int64_t& variable(const std::string &theName)
+{
+  auto variable = theVariables.find(theName);
+  if (theVariables.end() == variable)
+  {
+    throw std::runtime_error("'" + theName + "' isn't declared.");
+  }
+  return variable->second;
+}
+
+//**************************************************
+// value
+//**************************************************
+static int64_t value(const std::string &theOperand)
+{
+  if (! theOperand.empty() &&
+      ('-' == theOperand[0] || std::isdigit(theOperand[0])))
+  {
+    return std::stoll(theOperand);
+  }
+  return variable(theOperand);
+}
+
+//**************************************************
+// power
+//**************************************************
+static int64_t power(int64_t theBase, int64_t theExponent)
+{
+  // A negative exponent gives the integer part of the true result.
+  if (theExponent < 0)
+  {
+    if (1 == theBase || -1 == theBase)
+    {
+      return (theExponent & 1) ? theBase : 1;
+    }
+    return 0;
+  }
+  uint64_t result = 1;
+  uint64_t square = theBase;
+  for (uint64_t exponent = theExponent; exponent != 0; exponent >>= 1)
+  {
+    if (exponent & 1)
+    {
+      result *= square;
+    }
+    square *= square;
+  }
+  return static_cast<int64_t>(result);
+}
+
+//**************************************************
+// run
+//**************************************************
+static void run(std::istream &theCode)
+{
+  std::string line;
+  while (std::getline(theCode, line))
+  {
+    // "OP a, b, c": the op code, then operands separated by ", ".
+    std::istringstream stream(line);
+    std::string opCode;
+    stream >> opCode;
+    std::vector<std::string> operands;
+    std::string operand;
+    while (stream >> operand)
+    {
+      if (',' == operand.back())
+      {
+        operand.pop_back();
+      }
+      operands.push_back(operand);
+    }
+
+    auto arity = [&](std::size_t theCount)
+    {
+      if (operands.size() != theCount)
+      {
+        throw std::runtime_error("Malformed line '" + line + "'.");
+      }
+    };
+    if (opCode.empty())
+    {
+      continue;
+    }
+    else if ("Declare" == opCode)
+    {
+      arity(2);
+      theVariables.emplace(operands[0], 0);
+    }
+    else if ("Read" == opCode)
+    {
+      arity(2);
+      int64_t input;
+      if (1 != std::scanf("%" SCNd64, &input))
+      {
+        throw std::runtime_error("No input for '" + line + "'.");
+      }
+      variable(operands[0]) = input;
+    }
+    else if ("Write" == opCode)
+    {
+      arity(2);
+      std::printf("%" PRId64 "\n", value(operands[0]));
+    }
+    else if ("Store" == opCode)
+    {
+      // Store source, destination
+      arity(2);
+      variable(operands[1]) = value(operands[0]);
+    }
+    else if ("ADD" == opCode || "SUB" == opCode || "MUL" == opCode)
+    {
+      arity(3);
+      auto left = static_cast<uint64_t>(value(operands[0]));
+      auto right = static_cast<uint64_t>(value(operands[1]));
+      uint64_t result;
+      if ("ADD" == opCode)
+      {
+        result = left + right;
+      }
+      else if ("SUB" == opCode)
+      {
+        result = left - right;
+      }
+      else
+      {
+        result = left * right;
+      }
+      variable(operands[2]) = static_cast<int64_t>(result);
+    }
+    else if ("POW" == opCode)
+    {
+      arity(3);
+      variable(operands[2]) = power(value(operands[0]), value(operands[1]));
+    }
+    else if ("Halt" == opCode)
+    {
+      return;
+    }
+    else
+    {
+      throw std::runtime_error("Unknown instruction '" + line + "'.");
+    }
+  }
+  throw std::runtime_error("No Halt.");
+}
+
+int main(int argc, char **argv)
+{
+  try
+  {
+    bool statistics = false;
+    const char *fileName = nullptr;
+    for (int arg = 1; arg < argc; ++arg)
+    {
+      if (std::string("-s") == argv[arg])
+      {
+        statistics = true;
+      }
+      else if (nullptr == fileName)
+      {
+        fileName = argv[arg];
+      }
+      else
+      {
+        fileName = nullptr;
+        break;
+      }
+    }
+    if (nullptr == fileName)
+    {
+      throw std::runtime_error("Usage: interpret [-s] CODE_FILE");
+    }
+    std::ifstream code(fileName);
+    if (! code)
+    {
+      throw std::runtime_error(std::string("Can't open '") + fileName + "'.");
+    }
+    auto start = std::chrono::steady_clock::now();
+    run(code);
+    auto time = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+    if (statistics)
+    {
+      std::fflush(stdout);
+      std::cerr << std::setw(12) << time.count() << "  run time (us)"
+                << std::endl;
+    }
+  }
+  catch (const std::exception &exception)
+  {
+    std::fflush(stdout);
+    std::cerr << argv[0] << ": error: " << exception.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}